@@ -0,0 +1,355 @@
+//microbenchmarks of the interpreter internals that every Ash program leans on
+//usage: micro-bench [--json] [--filter=TEXT] [--min-time=MS]
+//prints ns per operation for each kernel as CSV (or JSON), one benchmark per line
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "token.h"
+#include "lexer.h"
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "symboltable.h"
+#include "casteval.h"
+#include "arithmeticeval.h"
+#include "utils.h"
+#include "array.h"
+#include "scratch.h"
+#include "microbench.h"
+
+#define DEFAULT_MIN_MILLIS 200
+
+///////////////////////////////////
+///////       Values        ///////
+///////////////////////////////////
+
+static ParseData integerData(ParseDataType type, uint64_t value) {
+	ParseData d;
+	d.type = type;
+	d.value.integer = value;
+	return d;
+}
+
+static ParseData doubleData(double value) {
+	ParseData d;
+	d.type = DOUBLE_T;
+	d.value.floatingPoint = value;
+	return d;
+}
+
+static ParseData stringData(const char* value) {
+	ParseData d;
+	d.type = STRING_T;
+	d.value.allocated = (void*) copyString(value);
+	return d;
+}
+
+static ParseData intArrayData(uint32_t length) {
+
+	Array* arr = (Array*) malloc(sizeof(Array));
+	arr->subtype = INT32_T;
+	arr->length = length;
+	arr->values = (ParseData*) malloc(sizeof(ParseData) * length);
+	for(uint32_t i = 0; i < length; i++)
+		arr->values[i] = integerData(INT32_T, i);
+
+	ParseData d;
+	d.type = ARRAY_T;
+	d.value.allocated = (void*) arr;
+	return d;
+}
+
+//strings made by a kernel are released right away so long runs don't grow the heap
+static void releaseString(ParseData result, ParseData orig) {
+	if(result.type == STRING_T && result.value.allocated != orig.value.allocated)
+		free(result.value.allocated);
+}
+
+///////////////////////////////////
+///////    Symbol Table     ///////
+///////////////////////////////////
+
+static void symbolTableBenchmarks(MicroBench& bench) {
+
+	std::string counter("counter");
+	ParseData value = integerData(INT32_T, 1);
+
+	SymbolTable shallow;
+	shallow.declare(counter, value);
+	bench.run("SymbolTable::get/same_scope", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++)
+			doNotOptimize(shallow.get(counter));
+	});
+
+	//a global read from inside nested blocks looks through every scope on the way out
+	SymbolTable deep;
+	deep.declare(counter, value);
+	for(uint32_t i = 0; i < 8; i++)
+		deep.enterNewScope();
+	bench.run("SymbolTable::get/8_scopes_out", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++)
+			doNotOptimize(deep.get(counter));
+	});
+
+	SymbolTable declared;
+	bench.run("SymbolTable::declare/existing", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++)
+			declared.declare(counter, value);
+	});
+
+	SymbolTable scoped;
+	bench.run("SymbolTable::enterNewScope+leaveScope", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++) {
+			scoped.enterNewScope();
+			scoped.leaveScope();
+		}
+	});
+
+	//what a call with one argument does to the table
+	SymbolTable called;
+	bench.run("SymbolTable::enterNewScope+declare+leaveScope", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++) {
+			called.enterNewScope();
+			called.declare(counter, value);
+			called.leaveScope();
+		}
+	});
+}
+
+///////////////////////////////////
+///////        Casts        ///////
+///////////////////////////////////
+
+static void castBenchmarks(MicroBench& bench) {
+
+	const char* names[] = {"int", "long", "uint", "ulong", "char", "bool", "double", "string"};
+	ParseDataType types[] = {INT32_T, INT64_T, UINT32_T, UINT64_T, CHAR_T, BOOL_T, DOUBLE_T, STRING_T};
+	ParseData values[] = {integerData(INT32_T, (uint32_t) -12345), integerData(INT64_T, 9000000000ULL),
+		integerData(UINT32_T, 4000000000U), integerData(UINT64_T, 18000000000000000000ULL), integerData(CHAR_T, 'a'),
+		integerData(BOOL_T, 1), doubleData(3.14159), stringData("12345")};
+
+	for(uint32_t from = 0; from < 8; from++) {
+		for(uint32_t to = 0; to < 8; to++) {
+			ParseData orig = values[from];
+			ParseDataType finalType = types[to];
+
+			bench.run(std::string("castHelper/") + names[from] + "->" + names[to], [&](uint64_t n) {
+				for(uint64_t i = 0; i < n; i++) {
+					ParseData result = castHelper(orig, finalType);
+					doNotOptimize(result);
+					releaseString(result, orig);
+				}
+			});
+		}
+	}
+}
+
+///////////////////////////////////
+///////     Arithmetic      ///////
+///////////////////////////////////
+
+static void arithmeticBenchmark(MicroBench& bench, const char* name, ParseOperatorType op, ParseData left, ParseData right) {
+
+	ArithmeticOperatorNode node(op, new LiteralNode(left, 1), new LiteralNode(right, 1));
+
+	//string results come from the scratch region and go back after each operation
+	bench.run(std::string("evaluateArithmeticExpression/") + name, [&](uint64_t n) {
+		ScratchScope scope(true);
+		ScratchMark mark = scratchMark();
+		for(uint64_t i = 0; i < n; i++) {
+			doNotOptimize(evaluateArithmeticExpression(&node));
+			scratchRelease(mark);
+		}
+	});
+}
+
+static void arithmeticBenchmarks(MicroBench& bench) {
+	arithmeticBenchmark(bench, "int+int", ADD_OP, integerData(INT32_T, 40), integerData(INT32_T, 2));
+	arithmeticBenchmark(bench, "long*long", MULTIPLY_OP, integerData(INT64_T, 40), integerData(INT64_T, 2));
+	arithmeticBenchmark(bench, "int/int", DIVIDE_OP, integerData(INT32_T, 40), integerData(INT32_T, 3));
+	arithmeticBenchmark(bench, "int%int", MOD_OP, integerData(INT32_T, 40), integerData(INT32_T, 3));
+	arithmeticBenchmark(bench, "double+double", ADD_OP, doubleData(1.5), doubleData(2.25));
+	arithmeticBenchmark(bench, "int+double", ADD_OP, integerData(INT32_T, 1), doubleData(2.25));
+	arithmeticBenchmark(bench, "string+string", ADD_OP, stringData("hello, "), stringData("world"));
+	arithmeticBenchmark(bench, "string+int", ADD_OP, stringData("line "), integerData(INT32_T, 12345));
+	arithmeticBenchmark(bench, "string+double", ADD_OP, stringData("ratio "), doubleData(0.1));
+	arithmeticBenchmark(bench, "string*int", MULTIPLY_OP, stringData("ab"), integerData(INT32_T, 16));
+}
+
+///////////////////////////////////
+///////     Conversions     ///////
+///////////////////////////////////
+
+static void toStringBenchmark(MicroBench& bench, const char* name, ParseData value) {
+	bench.run(std::string("toStringParseData/") + name, [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++) {
+			char* text = toStringParseData(value);
+			doNotOptimize(text);
+			free(text);
+		}
+	});
+}
+
+static void toStringBenchmarks(MicroBench& bench) {
+	toStringBenchmark(bench, "int", integerData(INT32_T, (uint32_t) -123456));
+	toStringBenchmark(bench, "ulong", integerData(UINT64_T, 18000000000000000000ULL));
+	toStringBenchmark(bench, "double", doubleData(0.1 + 0.2));
+	toStringBenchmark(bench, "bool", integerData(BOOL_T, 1));
+	toStringBenchmark(bench, "char", integerData(CHAR_T, 'a'));
+	toStringBenchmark(bench, "string", stringData("hello, world"));
+	toStringBenchmark(bench, "int_array_16", intArrayData(16));
+}
+
+///////////////////////////////////
+///////       Slicing       ///////
+///////////////////////////////////
+
+static void sliceBenchmarks(MicroBench& bench) {
+
+	std::string text(1000, 'x');
+	const char* str = text.c_str();
+	Array* arr = (Array*) intArrayData(1000).value.allocated;
+
+	bench.run("copySubstring/100_of_1000", [&](uint64_t n) {
+		ScratchScope scope(true);
+		ScratchMark mark = scratchMark();
+		for(uint64_t i = 0; i < n; i++) {
+			doNotOptimize(copySubstring(str, 100, 200));
+			scratchRelease(mark);
+		}
+	});
+
+	bench.run("copySubarray/100_of_1000", [&](uint64_t n) {
+		ScratchScope scope(true);
+		ScratchMark mark = scratchMark();
+		for(uint64_t i = 0; i < n; i++) {
+			doNotOptimize(copySubarray(arr, 100, 200));
+			scratchRelease(mark);
+		}
+	});
+}
+
+///////////////////////////////////
+///////       Lexing        ///////
+///////////////////////////////////
+
+static void keywordBenchmarks(MicroBench& bench) {
+
+	char keywords[][8] = {"while", "println", "return", "int", "string", "if", "else", "fun"};
+	char identifiers[][8] = {"counter", "x", "whilst", "total", "name", "i", "result", "funny"};
+
+	bench.run("varOrKeywordTokenType/keyword", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++)
+			doNotOptimize(varOrKeywordTokenType(keywords[i % 8]));
+	});
+
+	bench.run("varOrKeywordTokenType/identifier", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++)
+			doNotOptimize(varOrKeywordTokenType(identifiers[i % 8]));
+	});
+}
+
+//the same lines repeated, split the way the interpreter splits a source file
+struct SyntheticSource {
+	std::string code;
+	std::vector<char*> lines;
+};
+
+static void makeSource(SyntheticSource& source, const char** templateLines, uint32_t numTemplateLines, uint32_t numLines) {
+
+	for(uint32_t i = 0; i < numLines; i++) {
+		std::string line(templateLines[i % numTemplateLines]);
+		source.code += line + "\n";
+		source.lines.push_back(copyString((line + "\n").c_str()));
+	}
+}
+
+static void lexBenchmark(MicroBench& bench, const char* name, const char** templateLines, uint32_t numTemplateLines) {
+
+	SyntheticSource source;
+	makeSource(source, templateLines, numTemplateLines, 200);
+
+	std::vector<char> code(source.code.begin(), source.code.end());
+	code.push_back('\0');
+
+	bench.run(std::string("lex/") + name + "_200_lines", [&](uint64_t n) {
+		for(uint64_t i = 0; i < n; i++) {
+			std::vector<Token> tokens = lex(&code[0], &source.lines);
+			doNotOptimize(tokens.size());
+			for(uint32_t t = 0; t < tokens.size(); t++)
+				free((void*) tokens[t].lexeme);
+		}
+	});
+}
+
+static void lexBenchmarks(MicroBench& bench) {
+
+	const char* mixed[] = {
+		"fun scale(int value, double factor) -> double {",
+		"\treturn value * factor",
+		"}",
+		"int count = 0",
+		"string name = \"synthetic\"",
+		"while(count < 100 && count != 42) {",
+		"\tcount = count + 1",
+		"\tprintln name + \" \" + count",
+		"}",
+		"double ratio = scale(count, 2.5) / 3.75"
+	};
+
+	const char* numbers[] = {
+		"int a = 1234567 + 89 * 1011 - 121314",
+		"double b = 3.14159265358979 * 2.718281828 / 1.41421356",
+		"long c = 9000000000 + 123456789012"
+	};
+
+	const char* strings[] = {
+		"string greeting = \"Hello, world! This is a fairly long string literal.\"",
+		"println \"key: \" + \"value\" + \", another key: \" + \"another value\"",
+		"char c = 'x'"
+	};
+
+	lexBenchmark(bench, "mixed", mixed, sizeof(mixed) / sizeof(mixed[0]));
+	lexBenchmark(bench, "numbers", numbers, sizeof(numbers) / sizeof(numbers[0]));
+	lexBenchmark(bench, "strings", strings, sizeof(strings) / sizeof(strings[0]));
+}
+
+int main(int argc, char** argv) {
+
+	bool json = false;
+	const char* filter = NULL;
+	double minSeconds = DEFAULT_MIN_MILLIS / 1000.0;
+
+	for(int i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "--json") == 0) {
+			json = true;
+		} else if(strncmp(argv[i], "--filter=", 9) == 0) {
+			filter = argv[i] + 9;
+		} else if(strncmp(argv[i], "--min-time=", 11) == 0) {
+			minSeconds = atoi(argv[i] + 11) / 1000.0;
+		} else {
+			fprintf(stderr, "Usage: micro-bench [--json] [--filter=TEXT] [--min-time=MS]\n");
+			return 1;
+		}
+	}
+
+	MicroBench bench(minSeconds, filter);
+
+	symbolTableBenchmarks(bench);
+	castBenchmarks(bench);
+	arithmeticBenchmarks(bench);
+	toStringBenchmarks(bench);
+	sliceBenchmarks(bench);
+	keywordBenchmarks(bench);
+	lexBenchmarks(bench);
+
+	if(json)
+		bench.printJson(stdout);
+	else
+		bench.printCsv(stdout);
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+//header-only timing loop for the microbenchmarks of the interpreter internals
+//a benchmark is a function that runs its kernel n times, it is called with more and more iterations
+//until a batch takes long enough to time, then batches are repeated and the fastest one is reported
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+
+//shortest batch that is timed, shorter ones are only used to find the iteration count
+#define MICRO_MIN_BATCH_SECONDS 0.01
+
+//keeps the compiler from dropping a computation whose result is otherwise unused
+template <typename T>
+inline void doNotOptimize(const T& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct MicroResult {
+	std::string name;
+	uint64_t iterations;
+	double nanosPerOp;
+};
+
+class MicroBench {
+
+	public:
+		MicroBench(double minSeconds, const char* filter) {
+			this->minSeconds = minSeconds;
+			this->filter = filter;
+		}
+
+		template <typename Kernel>
+		void run(const std::string& name, Kernel kernel) {
+
+			if(filter != NULL && name.find(filter) == std::string::npos)
+				return;
+
+			//grow the batch until it can be timed
+			uint64_t iterations = 1;
+			double seconds = timeBatch(kernel, iterations);
+			while(seconds < MICRO_MIN_BATCH_SECONDS) {
+				iterations *= (seconds * 100 < MICRO_MIN_BATCH_SECONDS) ? 10 : 2;
+				seconds = timeBatch(kernel, iterations);
+			}
+
+			//the fastest batch has the least noise from the rest of the machine
+			double best = seconds;
+			double total = seconds;
+			while(total < minSeconds) {
+				seconds = timeBatch(kernel, iterations);
+				best = (seconds < best) ? seconds : best;
+				total += seconds;
+			}
+
+			MicroResult result;
+			result.name = name;
+			result.iterations = iterations;
+			result.nanosPerOp = best * 1e9 / iterations;
+			results.push_back(result);
+		}
+
+		//one line per benchmark, so runs of two commits can be joined on the name
+		void printCsv(FILE* out) {
+			fprintf(out, "benchmark,ns_per_op,iterations\n");
+			for(uint32_t i = 0; i < results.size(); i++)
+				fprintf(out, "%s,%.3f,%llu\n", results[i].name.c_str(), results[i].nanosPerOp, (unsigned long long) results[i].iterations);
+		}
+
+		void printJson(FILE* out) {
+			fprintf(out, "[\n");
+			for(uint32_t i = 0; i < results.size(); i++) {
+				fprintf(out, "  {\"benchmark\": \"%s\", \"nsPerOp\": %.3f, \"iterations\": %llu}%s\n", results[i].name.c_str(),
+					results[i].nanosPerOp, (unsigned long long) results[i].iterations, (i + 1 < results.size()) ? "," : "");
+			}
+			fprintf(out, "]\n");
+		}
+
+	private:
+		double minSeconds;
+		const char* filter;
+		std::vector<MicroResult> results;
+
+		template <typename Kernel>
+		double timeBatch(Kernel& kernel, uint64_t iterations) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			kernel(iterations);
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			return elapsed.count();
+		}
+};
+
+#endif
@@ -0,0 +1,437 @@
+//runs each benchmark program several times with the interpreter and reports
+//the median wall time, the peak resident memory and how many lines it printed per second
+//usage: bench-runner [--runs=N] [--save=FILE] [--baseline=FILE] [--tolerance=PCT] path/to/ash bench/*.ash
+//       bench-runner [--runs=N] --against=path/to/other-ash path/to/ash bench/*.ash
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#define DEFAULT_RUNS 5
+#define DEFAULT_TOLERANCE 10.0
+
+//resamples of the A/B bootstrap, seeded so a comparison is reproducible
+#define BOOTSTRAP_SAMPLES 2000
+#define BOOTSTRAP_SEED 0x9E3779B97F4A7C15ULL
+
+struct RunResult {
+	bool succeeded;
+	double seconds;
+	uint64_t peakKilobytes;
+	uint64_t lines;
+};
+
+//every run of one program with one interpreter
+struct Measurement {
+	std::string name;
+	bool succeeded;
+	std::vector<double> times;
+	uint64_t peakKilobytes;
+	uint64_t lines;
+};
+
+struct BaselineEntry {
+	double medianMs;
+	uint64_t peakKilobytes;
+};
+
+//ru_maxrss is in kilobytes on Linux and in bytes on macOS
+static uint64_t toKilobytes(long maxrss) {
+#ifdef __APPLE__
+	return (uint64_t) maxrss / 1024;
+#else
+	return (uint64_t) maxrss;
+#endif
+}
+
+//runs the program once with its output piped back here to be counted
+static RunResult runOnce(const char* interpreter, const char* program) {
+
+	RunResult result;
+	result.succeeded = false;
+	result.seconds = 0;
+	result.peakKilobytes = 0;
+	result.lines = 0;
+
+	int pipeEnds[2];
+	if(pipe(pipeEnds) != 0)
+		return result;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	pid_t child = fork();
+
+	if(child < 0)
+		return result;
+
+	if(child == 0) {
+		dup2(pipeEnds[1], STDOUT_FILENO);
+		close(pipeEnds[0]);
+		close(pipeEnds[1]);
+
+		execl(interpreter, interpreter, program, (char*) NULL);
+		_exit(127);
+	}
+
+	close(pipeEnds[1]);
+
+	char buffer[65536];
+	ssize_t length;
+	while((length = read(pipeEnds[0], buffer, sizeof(buffer))) > 0) {
+		for(ssize_t i = 0; i < length; i++)
+			result.lines += (buffer[i] == '\n');
+	}
+	close(pipeEnds[0]);
+
+	int status;
+	struct rusage usage;
+	if(wait4(child, &status, 0, &usage) != child)
+		return result;
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	result.succeeded = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	result.seconds = elapsed.count();
+	result.peakKilobytes = toKilobytes(usage.ru_maxrss);
+	return result;
+}
+
+static std::string benchmarkName(const char* path) {
+
+	std::string name(path);
+	size_t slash = name.find_last_of('/');
+	if(slash != std::string::npos)
+		name = name.substr(slash + 1);
+
+	size_t dot = name.find_last_of('.');
+	if(dot != std::string::npos)
+		name = name.substr(0, dot);
+
+	return name;
+}
+
+static Measurement newMeasurement(const char* program) {
+	Measurement measurement;
+	measurement.name = benchmarkName(program);
+	measurement.succeeded = true;
+	measurement.peakKilobytes = 0;
+	measurement.lines = 0;
+	return measurement;
+}
+
+static void addRun(Measurement& measurement, const char* interpreter, const char* program) {
+
+	if(!measurement.succeeded)
+		return;
+
+	RunResult result = runOnce(interpreter, program);
+	measurement.succeeded = result.succeeded;
+	measurement.times.push_back(result.seconds);
+	measurement.peakKilobytes = std::max(measurement.peakKilobytes, result.peakKilobytes);
+	measurement.lines = result.lines;
+}
+
+///////////////////////////////////
+///////     Statistics      ///////
+///////////////////////////////////
+
+static double median(std::vector<double> values) {
+	std::sort(values.begin(), values.end());
+	size_t n = values.size();
+	return (n % 2 == 1) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+//median absolute deviation, a spread that a single slow run doesn't inflate
+static double medianAbsoluteDeviation(const std::vector<double>& values) {
+	double center = median(values);
+	std::vector<double> deviations;
+	for(uint32_t i = 0; i < values.size(); i++)
+		deviations.push_back(fabs(values[i] - center));
+	return median(deviations);
+}
+
+//95% confidence interval of the median from the order statistics around it
+static void medianInterval(std::vector<double> values, double* low, double* high) {
+
+	std::sort(values.begin(), values.end());
+	double n = values.size();
+	int32_t lowRank = (int32_t) floor(n / 2 - 0.98 * sqrt(n));
+	int32_t highRank = (int32_t) ceil(n / 2 + 0.98 * sqrt(n));
+
+	*low = values[std::max(lowRank, 0)];
+	*high = values[std::min(highRank, (int32_t) n - 1)];
+}
+
+static uint64_t nextRandom(uint64_t* state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+static double resampledMedian(const std::vector<double>& values, uint64_t* state) {
+	std::vector<double> resample;
+	for(uint32_t i = 0; i < values.size(); i++)
+		resample.push_back(values[nextRandom(state) % values.size()]);
+	return median(resample);
+}
+
+//95% bootstrap interval of the relative change in median time from b to a, in percent
+static void changeInterval(const std::vector<double>& a, const std::vector<double>& b, double* low, double* high) {
+
+	uint64_t state = BOOTSTRAP_SEED;
+	std::vector<double> changes;
+	for(uint32_t i = 0; i < BOOTSTRAP_SAMPLES; i++)
+		changes.push_back(100 * (resampledMedian(a, &state) / resampledMedian(b, &state) - 1));
+
+	std::sort(changes.begin(), changes.end());
+	*low = changes[BOOTSTRAP_SAMPLES * 25 / 1000];
+	*high = changes[BOOTSTRAP_SAMPLES * 975 / 1000 - 1];
+}
+
+///////////////////////////////////
+///////      Baselines      ///////
+///////////////////////////////////
+
+//one benchmark per line, so the file diffs well when it is updated
+static bool saveBaseline(const char* file, std::vector<Measurement>& measurements) {
+
+	FILE* out = fopen(file, "w");
+	if(out == NULL)
+		return false;
+
+	fprintf(out, "{\n");
+	for(uint32_t i = 0; i < measurements.size(); i++) {
+		fprintf(out, "  \"%s\": {\"medianMs\": %.1f, \"peakKb\": %llu}%s\n", measurements[i].name.c_str(),
+			median(measurements[i].times) * 1000, (unsigned long long) measurements[i].peakKilobytes,
+			(i + 1 < measurements.size()) ? "," : "");
+	}
+	fprintf(out, "}\n");
+
+	fclose(out);
+	return true;
+}
+
+//reads the files written by saveBaseline, lines that don't hold a benchmark are skipped
+static bool loadBaseline(const char* file, std::map<std::string, BaselineEntry>& baseline) {
+
+	FILE* in = fopen(file, "r");
+	if(in == NULL)
+		return false;
+
+	char line[1024];
+	while(fgets(line, sizeof(line), in) != NULL) {
+		char name[256];
+		BaselineEntry entry;
+		unsigned long long peak;
+
+		if(sscanf(line, " \"%255[^\"]\": {\"medianMs\": %lf, \"peakKb\": %llu}", name, &entry.medianMs, &peak) == 3) {
+			entry.peakKilobytes = peak;
+			baseline[name] = entry;
+		}
+	}
+
+	fclose(in);
+	return true;
+}
+
+//prints a line for every metric that got worse than the tolerance allows, true if there was one
+static bool reportRegressions(std::vector<Measurement>& measurements, std::map<std::string, BaselineEntry>& baseline, double tolerance) {
+
+	bool regressed = false;
+	printf("\ncompared with the baseline (tolerance %.1f%%):\n", tolerance);
+
+	for(uint32_t i = 0; i < measurements.size(); i++) {
+		Measurement& measurement = measurements[i];
+		if(!measurement.succeeded)
+			continue;
+
+		std::map<std::string, BaselineEntry>::iterator it = baseline.find(measurement.name);
+		if(it == baseline.end()) {
+			printf("  %-12s not in the baseline\n", measurement.name.c_str());
+			continue;
+		}
+
+		double medianMs = median(measurement.times) * 1000;
+		double timeChange = 100 * (medianMs / it->second.medianMs - 1);
+		double memoryChange = 100 * ((double) measurement.peakKilobytes / it->second.peakKilobytes - 1);
+
+		bool slower = timeChange > tolerance;
+		bool larger = memoryChange > tolerance;
+
+		printf("%s %-12s median %10.1f ms vs %10.1f ms (%+6.1f%%)   peak %8.1f MB vs %8.1f MB (%+6.1f%%)\n",
+			(slower || larger) ? "REGRESSED" : "  ok     ", measurement.name.c_str(), medianMs, it->second.medianMs,
+			timeChange, measurement.peakKilobytes / 1024.0, it->second.peakKilobytes / 1024.0, memoryChange);
+
+		regressed = regressed || slower || larger;
+	}
+
+	return regressed;
+}
+
+///////////////////////////////////
+///////       Reports       ///////
+///////////////////////////////////
+
+static void printMeasurements(std::vector<Measurement>& measurements, const char* interpreter, std::vector<const char*>& programs) {
+
+	printf("%-12s %10s %8s %21s %10s %14s\n", "benchmark", "median ms", "mad ms", "95% ci ms", "peak MB", "lines/s");
+
+	for(uint32_t i = 0; i < measurements.size(); i++) {
+		Measurement& measurement = measurements[i];
+
+		if(!measurement.succeeded) {
+			printf("%-12s failed (see: %s %s)\n", measurement.name.c_str(), interpreter, programs[i]);
+			continue;
+		}
+
+		double low, high;
+		double center = median(measurement.times);
+		medianInterval(measurement.times, &low, &high);
+
+		printf("%-12s %10.1f %8.1f %10.1f - %8.1f %10.1f %14.0f\n", measurement.name.c_str(), center * 1000,
+			medianAbsoluteDeviation(measurement.times) * 1000, low * 1000, high * 1000,
+			measurement.peakKilobytes / 1024.0, measurement.lines / center);
+	}
+}
+
+//a is the interpreter under test and b the one it is compared against
+static bool printComparison(std::vector<Measurement>& a, std::vector<Measurement>& b) {
+
+	bool failed = false;
+	printf("%-12s %12s %12s %9s %19s %8s  %s\n", "benchmark", "A median ms", "B median ms", "change", "95% ci", "A/B MB", "verdict");
+
+	for(uint32_t i = 0; i < a.size(); i++) {
+
+		if(!a[i].succeeded || !b[i].succeeded) {
+			printf("%-12s failed with %s\n", a[i].name.c_str(), !a[i].succeeded ? "A" : "B");
+			failed = true;
+			continue;
+		}
+
+		double aMedian = median(a[i].times);
+		double bMedian = median(b[i].times);
+		double low, high;
+		changeInterval(a[i].times, b[i].times, &low, &high);
+
+		//only an interval that doesn't hold zero says A differs from B
+		const char* verdict = (high < 0) ? "A faster" : (low > 0) ? "A slower" : "no difference";
+
+		printf("%-12s %12.1f %12.1f %+8.1f%% %+8.1f%% .. %+6.1f%% %8.2f  %s\n", a[i].name.c_str(), aMedian * 1000,
+			bMedian * 1000, 100 * (aMedian / bMedian - 1), low, high, (double) a[i].peakKilobytes / b[i].peakKilobytes, verdict);
+	}
+
+	return failed;
+}
+
+static void usage() {
+	fprintf(stderr, "Usage: bench-runner [--runs=N] [--save=FILE] [--baseline=FILE] [--tolerance=PCT] path/to/ash program.ash...\n");
+	fprintf(stderr, "       bench-runner [--runs=N] --against=path/to/other-ash path/to/ash program.ash...\n");
+}
+
+int main(int argc, char** argv) {
+
+	uint32_t runs = DEFAULT_RUNS;
+	const char* saveFile = NULL;
+	const char* baselineFile = NULL;
+	const char* against = NULL;
+	double tolerance = DEFAULT_TOLERANCE;
+	int first = 1;
+
+	for(; first < argc && strncmp(argv[first], "--", 2) == 0; first++) {
+		if(strncmp(argv[first], "--runs=", 7) == 0) {
+			runs = (uint32_t) atoi(argv[first] + 7);
+		} else if(strncmp(argv[first], "--save=", 7) == 0) {
+			saveFile = argv[first] + 7;
+		} else if(strncmp(argv[first], "--baseline=", 11) == 0) {
+			baselineFile = argv[first] + 11;
+		} else if(strncmp(argv[first], "--tolerance=", 12) == 0) {
+			tolerance = atof(argv[first] + 12);
+		} else if(strncmp(argv[first], "--against=", 10) == 0) {
+			against = argv[first] + 10;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+
+	if(runs == 0 || argc - first < 2) {
+		usage();
+		return 1;
+	}
+
+	const char* interpreter = argv[first];
+	std::vector<const char*> programs(argv + first + 1, argv + argc);
+
+	std::vector<Measurement> measurements;
+	std::vector<Measurement> againstMeasurements;
+
+	for(uint32_t i = 0; i < programs.size(); i++) {
+		Measurement measurement = newMeasurement(programs[i]);
+		Measurement againstMeasurement = newMeasurement(programs[i]);
+
+		//A/B runs alternate which interpreter goes first, so drift on the machine hits both alike
+		for(uint32_t run = 0; run < runs; run++) {
+			if(against != NULL && run % 2 == 1)
+				addRun(againstMeasurement, against, programs[i]);
+
+			addRun(measurement, interpreter, programs[i]);
+
+			if(against != NULL && run % 2 == 0)
+				addRun(againstMeasurement, against, programs[i]);
+		}
+
+		measurements.push_back(measurement);
+		againstMeasurements.push_back(againstMeasurement);
+	}
+
+	if(against != NULL) {
+		printf("A: %s\nB: %s\n", interpreter, against);
+		return printComparison(measurements, againstMeasurements) ? 1 : 0;
+	}
+
+	printMeasurements(measurements, interpreter, programs);
+
+	bool failed = false;
+	for(uint32_t i = 0; i < measurements.size(); i++)
+		failed = failed || !measurements[i].succeeded;
+
+	if(saveFile != NULL) {
+		if(failed) {
+			fprintf(stderr, "Not saving a baseline while a benchmark fails\n");
+			return 1;
+		}
+
+		if(!saveBaseline(saveFile, measurements)) {
+			fprintf(stderr, "Couldn't write the baseline to %s\n", saveFile);
+			return 1;
+		}
+	}
+
+	if(baselineFile != NULL) {
+		std::map<std::string, BaselineEntry> baseline;
+		if(!loadBaseline(baselineFile, baseline)) {
+			fprintf(stderr, "Couldn't read the baseline %s\n", baselineFile);
+			return 1;
+		}
+
+		if(reportRegressions(measurements, baseline, tolerance)) {
+			printf("\nregressed beyond %.1f%% of the baseline in %s\n", tolerance, baselineFile);
+			failed = true;
+		}
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,19 @@
+#ifndef ALLOCPROFILE_H
+#define ALLOCPROFILE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//set by --alloc-profile, every value allocation is then attributed to the line that is running
+extern bool allocProfiling;
+
+void recordAllocation(size_t size, bool scratch);
+
+//a heap value given back with freeHeap is no longer live
+void recordFree(size_t size);
+
+//starts attributing allocations, the report goes to the file (stderr if NULL) when the interpreter exits
+void startAllocProfiling(std::vector<char*>* codeLines, const char* reportFile);
+
+#endif
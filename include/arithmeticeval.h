@@ -7,4 +7,17 @@
 //evaluates ** * / % + -
 ParseData evaluateArithmeticExpression(ArithmeticOperatorNode* node);
 
+//applies ** * / % + - to already evaluated operands
+ParseData arithmeticOperation(ParseOperatorType operation, ParseData left, ParseData right);
+
+//true for a string + (possibly in parentheses), the links a ConcatenationNode is made of
+bool isStringConcatenation(AbstractExpressionNode* node);
+
+//joins every operand of a string + chain into one newly allocated string
+ParseData evaluateConcatenationExpression(ConcatenationNode* node);
+
+//strength-reduced forms of ** / %
+ParseData evaluateIntegerPowerExpression(IntegerPowerNode* node);
+ParseData evaluateConstantDivisionExpression(ConstantDivisionNode* node);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef ASH_H
+#define ASH_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <stdexcept>
+#include "parsetoken.h"
+#include "optimizer.h"
+#include "native.h"
+
+class CompiledProgram;
+
+//runs Ash programs from C++ without the ash command, link with bin/libash.a or bin/libash.so
+namespace ash {
+
+//a lexer, parser or runtime error, with the message the ash command would print
+class Error : public std::runtime_error {
+
+	public:
+		Error(const std::string& message);
+};
+
+//values of an engine's globals for one run, converted to their declared types like a cast would
+class Globals {
+
+	public:
+		void set(const std::string& name, int32_t value);
+		void set(const std::string& name, int64_t value);
+		void set(const std::string& name, double value);
+		void set(const std::string& name, bool value);
+		void set(const std::string& name, const char* value);
+		void set(const std::string& name, const std::string& value);
+
+	private:
+		friend class Program;
+
+		struct Value {
+			ParseDataType type;
+			int64_t integer;
+			double floatingPoint;
+			std::string string;
+		};
+
+		std::map<std::string, Value> values;
+};
+
+//a compiled program, it is never changed by running it, so it can run any number of times and on several threads at once
+class Program {
+
+	public:
+		~Program();
+
+		//appends what the program prints to output, throws Error if it fails (output has what it printed until then)
+		//globals that aren't given a value are 0, false or ""
+		void run(std::string& output, const Globals& globals = Globals()) const;
+		std::string run(const Globals& globals = Globals()) const;
+
+	private:
+		friend class Engine;
+
+		CompiledProgram* program;
+		std::vector<std::pair<std::string, ParseDataType> > globals;
+
+		Program(CompiledProgram* program, const std::vector<std::pair<std::string, ParseDataType> >& globals);
+		Program(const Program&) = delete;
+		Program& operator=(const Program&) = delete;
+};
+
+//compiles programs, everything a program needs belongs to it so an engine can go away before its programs
+class Engine {
+
+	public:
+		Engine();
+		Engine(OptimizerOptions options);
+
+		//programs compiled from now on can use name without declaring it, only primitive and string types
+		void declareGlobal(const std::string& name, ParseDataType type);
+
+		//programs compiled from now on can call name like a function with these argument types, see NativeCallback
+		//only primitive and string types, or void for the return type, the program's own names hide it
+		void registerNative(const std::string& name, ParseDataType returnType, const std::vector<ParseDataType>& argTypes, NativeCallback call);
+
+		//the program is the caller's to delete, throws Error if it doesn't compile
+		Program* compile(const std::string& source) const;
+		Program* compileFile(const std::string& path) const;
+
+	private:
+		OptimizerOptions options;
+		std::vector<std::pair<std::string, ParseDataType> > globals;
+		std::vector<NativeFunction> natives;
+};
+
+}
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <vector>
+#include "statementnode.h"
+
+//drop bounds checks on array accesses indexed by a for loop variable that can't leave the array
+void eliminateBoundsChecks(std::vector<AbstractStatementNode*>* statements);
+
+#endif
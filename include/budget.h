@@ -0,0 +1,25 @@
+#ifndef BUDGET_H
+#define BUDGET_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//units of fuel left before the next check, each statement, loop iteration and call burns one
+extern thread_local uint64_t fuelCountdown;
+
+//throws a LimitExceededException if the fuel is used up or the deadline has passed
+void checkBudget(uint32_t line);
+
+inline void burnFuel(uint32_t line) {
+	if(--fuelCountdown == 0)
+		checkBudget(line);
+}
+
+//throws a LimitExceededException on the running line, the allocation of size bytes would pass the heap limit
+void exceedHeapLimit(size_t size);
+
+//limits of the run that starts now, 0 for none: units of fuel, seconds of wall-clock time and bytes of strings and arrays
+void startBudget(std::vector<char*>* codeLines, uint64_t fuel, double timeoutSeconds, size_t maxHeapBytes);
+
+#endif
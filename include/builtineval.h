@@ -0,0 +1,14 @@
+#ifndef BUILTINEVAL_H
+#define BUILTINEVAL_H
+
+#include <cstdint>
+#include "parsetoken.h"
+#include "parsenode.h"
+
+//nanoseconds from a monotonic wall clock, and of CPU time used by the interpreter
+uint64_t nanotime();
+uint64_t cputime();
+
+ParseData evaluateBuiltinFunctionExpression(BuiltinFunctionNode* node);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef CALLPROFILE_H
+#define CALLPROFILE_H
+
+#include <cstdint>
+#include "function.h"
+
+//set by --call-profile, every call is timed while it is on
+extern bool callProfiling;
+
+//nanoseconds from a monotonic clock
+uint64_t callProfileClock();
+
+//the arguments of a call to function have been evaluated since argumentsStart and its body starts now
+void enterProfiledCall(Function* function, uint64_t argumentsStart, bool inlined);
+
+//a tail call reruns the body of the innermost call instead of entering a new one
+void countProfiledTailCall();
+
+//the body of the innermost call has finished
+void leaveProfiledCall();
+
+//starts timing calls, the report goes to the file (stderr if NULL) when the interpreter exits
+void startCallProfiling(const char* reportFile);
+
+#endif
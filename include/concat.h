@@ -0,0 +1,10 @@
+#ifndef CONCAT_H
+#define CONCAT_H
+
+#include <vector>
+#include "statementnode.h"
+
+//turn chains like a + b + c on strings into a single concatenation of all operands
+void fuseConcatenations(std::vector<AbstractStatementNode*>* statements);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <cstdint>
+#include <vector>
+#include "parsetoken.h"
+#include "symboltable.h"
+#include "profile.h"
+
+//slot of a node that has no storage
+#define NO_SLOT UINT32_MAX
+
+//one call of a function that hasn't returned yet
+struct FunctionFrame {
+	ParseData returnValue;
+	bool returned;
+
+	//set by a return of a call to the same function, which reruns the body with these arguments
+	bool isTailCall;
+	ParseData* tailArguments;
+};
+
+//everything one run of a program changes, the parsed tree is only read while it runs
+//so the same tree can run in several contexts at once, one per thread
+class ExecutionContext {
+
+	public:
+		SymbolTable variables;
+		FunctionFrame* frame; //innermost call, NULL outside of functions
+		ParseData* slots; //values the optimizer's nodes keep between evaluations
+		std::vector<void*> heap; //strings and arrays of the run when it is the heap owner, freed with the context
+
+		ExecutionContext(uint32_t numSlots);
+		~ExecutionContext();
+
+	private:
+		//the profiler's shadow stack when the context was made, a run inside another one (from a native function)
+		//pushes its calls on top and leaves it as it found it, also when it ends in an error
+		ProfileFrame* previousProfileTop;
+		uint32_t previousProfileDepth;
+};
+
+//the context whose program is running on this thread
+extern thread_local ExecutionContext* runningContext;
+
+//reserves storage for count values in every context that runs the program being compiled, returns the first slot
+uint32_t reserveSlots(uint32_t count);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+//execution counts for a build made with -DCOUNTERS (make counters), every macro compiles to nothing otherwise
+
+#ifdef COUNTERS
+
+#include <cstdint>
+#include "parsetoken.h"
+
+//counting starts with execution, so what the parser and optimizer do isn't mixed in
+extern bool counting;
+
+uint64_t* registerCounter(const char* name);
+void countOperation(ParseOperatorType operation, ParseDataType left, ParseDataType right);
+void countCast(ParseDataType from, ParseDataType to);
+void countLookup(uint32_t scopesSearched, bool found);
+
+void startCounting();
+
+//each use keeps a pointer to its own counter, found once
+#define COUNT_NODE(name) do { static uint64_t* counter = registerCounter(name); *counter += counting; } while(0)
+#define COUNT_OPERATION(operation, left, right) do { if(counting) countOperation(operation, left, right); } while(0)
+#define COUNT_CAST(from, to) do { if(counting) countCast(from, to); } while(0)
+#define COUNT_LOOKUP(scopesSearched, found) do { if(counting) countLookup(scopesSearched, found); } while(0)
+
+#else
+
+#define COUNT_NODE(name)
+#define COUNT_OPERATION(operation, left, right)
+#define COUNT_CAST(from, to)
+#define COUNT_LOOKUP(scopesSearched, found)
+
+#endif
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef CSE_H
+#define CSE_H
+
+#include <vector>
+#include "statementnode.h"
+
+//compute repeated side-effect free subexpressions once per straight-line run of statements
+void eliminateCommonSubexpressions(std::vector<AbstractStatementNode*>* statements);
+
+#endif
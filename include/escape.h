@@ -0,0 +1,10 @@
+#ifndef ESCAPE_H
+#define ESCAPE_H
+
+#include <vector>
+#include "statementnode.h"
+
+//flag string and array results that are dropped within their statement, so they can use scratch memory
+void markTemporaries(std::vector<AbstractStatementNode*>* statements);
+
+#endif
@@ -15,6 +15,7 @@
 #include "casteval.h"
 #include "functioneval.h"
 #include "arrayeval.h"
+#include "builtineval.h"
 
 //recursively evaluate AST, start at root
 ParseData evaluate(AbstractExpressionNode* node);
@@ -28,5 +28,33 @@ class OutOfBoundsException : public std::exception {
 		const char* what() const throw ();
 };
 
+//running past a limit set with --fuel, --timeout or --max-heap
+class LimitExceededException : public std::exception {
+
+	public:
+		char* message;
+		char* context;
+		uint32_t line;
+
+		LimitExceededException(char* mes, char* con, uint32_t lin)
+			: message{mes}, context{con}, line{lin} {}
+
+		const char* what() const throw ();
+};
+
+//error reported by a native function, the call that ran it fills in where it happened
+class NativeException : public std::exception {
+
+	public:
+		char* message;
+		char* context;
+		uint32_t startLine;
+		uint32_t endLine;
+
+		NativeException(const char* mes);
+
+		const char* what() const throw ();
+};
+
 
 #endif
\ No newline at end of file
@@ -14,6 +14,8 @@ void executePrintStatement(PrintStatementNode* node);
 
 void executePrintLineStatement(PrintLineStatementNode* node);
 
+void executePrintFormattedStatement(PrintFormattedStatementNode* node);
+
 void executeGroupedStatement(GroupedStatementNode* node);
 
 void executeConditionalStatement(ConditionalStatementNode* node);
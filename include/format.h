@@ -0,0 +1,33 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <vector>
+#include <cstdint>
+#include "parsetoken.h"
+
+//printf formats are split once when they are parsed, into pieces of literal text each followed by a conversion
+struct FormatSpecifier {
+	const char* text;
+	uint32_t textLength;
+
+	//one of d i u x X f e g c s, '%' for a literal percent sign, or 0 after the last conversion
+	char conversion;
+	bool leftAlign;
+	bool zeroPad;
+	uint32_t width;
+	int32_t precision;
+};
+
+//splits the format into specifiers, returns an error message if it is malformed
+const char* parseFormat(const char* format, std::vector<FormatSpecifier>& specifiers);
+
+//true if the conversion prints one of the values
+bool consumesValue(char conversion);
+
+//true if a value of the type can be printed with the conversion (%s takes anything)
+bool acceptsType(char conversion, ParseDataType type);
+
+//writes the text and values to the print buffer, one value per consuming specifier
+void printFormatted(std::vector<FormatSpecifier>& specifiers, ParseData* values);
+
+#endif
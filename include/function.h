@@ -11,6 +11,7 @@ class AbstractStatementNode;
 
 //holds function information
 struct Function {
+	char* name;
 	uint32_t numArgs;
 	ParseDataType* argTypes;
 	ParseDataType* argSubTypes; //used if argType is an array
@@ -18,10 +19,7 @@ struct Function {
 	std::vector<AbstractStatementNode*>* body;
 	ParseDataType returnType;
 
-	//used by return statement to indicate function termination
-	//and place the return value somewhere
-	ParseData* returnValue;
-	bool* returnFlag;
+	//where a call returns to and its tail call arguments are in the running context's FunctionFrame
 };
 
 #endif
\ No newline at end of file
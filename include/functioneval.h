@@ -5,5 +5,7 @@
 #include "parsenode.h"
 
 ParseData evaluateFunctionExpression(FunctionExpressionNode* node);
+ParseData evaluateInlinedFunctionExpression(InlinedFunctionNode* node);
+ParseData evaluateNativeFunctionExpression(NativeFunctionNode* node);
 
 #endif
\ No newline at end of file
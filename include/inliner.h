@@ -0,0 +1,11 @@
+#ifndef INLINER_H
+#define INLINER_H
+
+#include <vector>
+#include <cstdint>
+#include "statementnode.h"
+
+//substitute bodies of small non-recursive functions at their call sites
+void inlineFunctionCalls(std::vector<AbstractStatementNode*>* statements, uint32_t threshold);
+
+#endif
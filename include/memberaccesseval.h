@@ -7,5 +7,8 @@
 //used to access members and subarrays of strings and arrays
 ParseData evaluateArrayAccess(ArrayAccessNode* node);
 
+//element access without bounds checks or negative indices, when the enclosing loop allows it
+ParseData evaluateUncheckedArrayAccess(UncheckedArrayAccessNode* node);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <csignal>
+
+//snapshots asked for by SIGUSR1 or the interval timer and not yet written, set by the signal handlers
+extern volatile sig_atomic_t pendingMetrics;
+
+//writes a snapshot of the running program, called at the start of a statement where it is safe to do so
+void dumpMetrics();
+
+//SIGUSR1 writes a snapshot to the file (appended to, stderr if NULL), and so does every intervalSeconds if not 0
+void startMetrics(const char* sourceFile, const char* metricsFile, uint32_t intervalSeconds);
+
+#endif
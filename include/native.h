@@ -0,0 +1,32 @@
+#ifndef NATIVE_H
+#define NATIVE_H
+
+#include <string>
+#include <vector>
+#include "parsetoken.h"
+
+//the arguments have exactly the declared types, and are only valid until the function returns
+//a string result must be a new one from allocateValue, the type of the result is set by the caller
+//to stop the program with a runtime error on the calling line, throw a NativeException
+typedef ParseData (*NativeCallback)(ParseData* arguments);
+
+//a C++ function Ash programs can call like one of their own, without a scope of its own
+//arguments and results are primitives or strings, the result can also be void
+struct NativeFunction {
+	std::string name;
+	std::vector<ParseDataType> argTypes;
+	ParseDataType returnType;
+	NativeCallback call;
+};
+
+//true if natives can take or return values of the type
+bool isNativeParseDataType(ParseDataType type, bool isReturnType);
+
+//the native a program being compiled calls by name, the ones of its engine first and then the standard ones
+//NULL if there is none, only used if the program hasn't declared the name itself
+const NativeFunction* findNativeFunction(const std::string& name);
+
+//math and string functions every program can call
+const std::vector<NativeFunction>& standardNativeFunctions();
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef NUMCONV_H
+#define NUMCONV_H
+
+#include <cstdint>
+
+//longest text any of the format functions writes (they don't add a terminator)
+#define MAX_NUMBER_LENGTH 32
+
+//number of decimal digits in the value
+uint32_t decimalLength(uint64_t value);
+
+//each of these writes the number at out and returns the number of chars written
+uint32_t formatUnsigned(uint64_t value, char* out);
+uint32_t formatSigned(int64_t value, char* out);
+
+//shortest text that reads back as the same double, e.g. 0.1, 2.0, 1e+16 or 1.5e-07
+uint32_t formatDouble(double value, char* out);
+
+//correctly rounded value of a decimal literal made of digits and at most one decimal point
+double parseDouble(const char* str, uint32_t length);
+
+#endif
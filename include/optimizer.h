@@ -0,0 +1,40 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "parsenode.h"
+#include "statementnode.h"
+
+//knobs for the AST passes run between parse and execution
+struct OptimizerOptions {
+	bool inlineFunctions;
+	uint32_t inlineThreshold; //max number of nodes in an inlined return expression
+};
+
+OptimizerOptions defaultOptimizerOptions();
+
+//runs every enabled pass over the program
+void optimize(std::vector<AbstractStatementNode*>* statements, OptimizerOptions options);
+
+//child expression slots of a node, in the order the evaluators visit them
+std::vector<AbstractExpressionNode**> childExpressions(AbstractExpressionNode* node);
+std::vector<AbstractExpressionNode**> childExpressions(AbstractStatementNode* node);
+
+//child statements of a statement (includes the body of a declared function)
+std::vector<AbstractStatementNode*> childStatements(AbstractStatementNode* node);
+
+//number of nodes in an expression tree
+uint32_t expressionSize(AbstractExpressionNode* node);
+
+//value of a non-negative int literal, -1 for anything else
+int64_t intLiteralValue(AbstractExpressionNode* node);
+
+//how much a for loop's update adds to its variable, 0 if it isn't a simple constant step
+int64_t loopStep(AbstractStatementNode* update, std::string variable);
+
+//deep copy of an expression tree (leaves shared pointers to symbol table and functions intact)
+AbstractExpressionNode* cloneExpression(AbstractExpressionNode* node);
+
+#endif
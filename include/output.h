@@ -0,0 +1,28 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <cstddef>
+#include <string>
+#include "parsetoken.h"
+
+//print and println go through one large buffer that is written out when it fills up,
+//when the program ends, before an error message, and after every print if line buffered
+void setLineBuffered(bool lineBuffered);
+
+//writes the value with the same text as toStringParseData, optionally followed by a newline
+void printValue(ParseData d, bool newline);
+
+void writeOutput(const char* str, size_t length);
+void flushOutput();
+
+//output flushed on this thread from now on is appended to into instead of written to stdout, NULL goes back to stdout
+//returns where output went before
+std::string* captureOutput(std::string* into);
+
+//writes the value without a newline or flush, elements of arrays are written one by one
+void writeValue(ParseData d);
+
+//flushes if line buffered, called once a whole print statement is written
+void endPrint();
+
+#endif
@@ -5,6 +5,7 @@
 #include "parsetoken.h"
 #include "symboltable.h"
 #include "function.h"
+#include "native.h"
 
 //forward declarations to break cyclic dependencies with function.h and statementnode.h
 struct Function;
@@ -21,6 +22,12 @@ class AbstractExpressionNode {
     uint32_t endLine;
     ParseDataType evalType;
 		ParseDataType subType;
+
+    //nodes, copies included, belong to the program being compiled
+    AbstractExpressionNode();
+    AbstractExpressionNode(const AbstractExpressionNode& node);
+    virtual ~AbstractExpressionNode() {}
+
     virtual ParseData evaluate() = 0;
     virtual std::string toString() = 0;
 };
@@ -90,10 +97,57 @@ class AbstractBinaryOperatorNode : public AbstractOperatorNode {
 //class that represents arithmetic
 class ArithmeticOperatorNode : public AbstractBinaryOperatorNode {
   public:
+    bool isTemporary; //string or array result is dropped before the statement ends
     ArithmeticOperatorNode(ParseOperatorType op, AbstractExpressionNode* l, AbstractExpressionNode* r);
     ParseData evaluate();
 };
 
+//chain of string concatenations, built with a single allocation
+class ConcatenationNode : public AbstractExpressionNode {
+  public:
+    AbstractExpressionNode* expression; //original chain, replayed if an operand isn't the type it was parsed as
+    AbstractExpressionNode** operands;
+    uint32_t numOperands;
+    bool isTemporary;
+    ConcatenationNode(AbstractExpressionNode* expression, AbstractExpressionNode** operands, uint32_t numOperands);
+    ParseData evaluate();
+    std::string toString();
+};
+
+//raises to a small constant integer power by repeated multiplication
+class IntegerPowerNode : public AbstractExpressionNode {
+  public:
+    AbstractExpressionNode* base;
+    ParseData exponent;
+    IntegerPowerNode(ArithmeticOperatorNode* power);
+    ParseData evaluate();
+    std::string toString();
+};
+
+//divides (or mods) by a positive constant with shifts, masks and multiply-high
+class ConstantDivisionNode : public AbstractExpressionNode {
+  public:
+    ParseOperatorType operation;
+    AbstractExpressionNode* dividend;
+    ParseData divisor;
+    uint32_t shift;      //log2 of divisor if it's a power of two
+    bool isPowerOfTwo;
+    uint64_t multiplier; //ceil(2^64 / divisor), used for 32-bit dividends
+    ConstantDivisionNode(ArithmeticOperatorNode* division);
+    ParseData evaluate();
+    std::string toString();
+};
+
+//loop variable times a constant, kept up to date by additions in the enclosing for loop
+class InductionVariableNode : public AbstractExpressionNode {
+  public:
+    AbstractExpressionNode* product;
+    uint32_t value; //slot
+    InductionVariableNode(AbstractExpressionNode* product, uint32_t value);
+    ParseData evaluate();
+    std::string toString();
+};
+
 //class that represents bitwise and logical operations
 class BitLogicalOperatorNode : public AbstractBinaryOperatorNode {
   public:
@@ -135,6 +189,7 @@ class ArrayAccessNode : public AbstractExpressionNode {
     AbstractExpressionNode* end;
 		char* context;
     bool isSlice;
+    bool isTemporary; //slice is dropped before the statement ends
     
     ArrayAccessNode(AbstractExpressionNode* arr, AbstractExpressionNode* s, char* context, uint32_t endLine);
     ArrayAccessNode(AbstractExpressionNode* arr, AbstractExpressionNode* s, AbstractExpressionNode* e, char* context, uint32_t endLine);
@@ -143,6 +198,18 @@ class ArrayAccessNode : public AbstractExpressionNode {
     std::string toString();
 };
 
+//array element access whose index was proven in range before the enclosing loop started
+class UncheckedArrayAccessNode : public AbstractExpressionNode {
+
+  public:
+    ArrayAccessNode* access; //original access, evaluated with checks when the proof didn't hold
+    uint32_t inRange; //slot
+
+    UncheckedArrayAccessNode(ArrayAccessNode* access, uint32_t inRange);
+    ParseData evaluate();
+    std::string toString();
+};
+
 //represents an array of primitive values
 class ArrayNode : public AbstractExpressionNode {
 
@@ -179,14 +246,51 @@ class FunctionExpressionNode : public AbstractExpressionNode {
 		AbstractExpressionNode** arguments;
 		Function* function;
 		SymbolTable* symbolTable;
-		bool* isReturned;
-		ParseData* returnValue;
 
 		FunctionExpressionNode(uint32_t numArgs, AbstractExpressionNode** arguments, Function* function, SymbolTable* symbolTable, uint32_t startLine, uint32_t endLine);	
 		ParseData evaluate();
 		std::string toString();
 };
 
+//call whose body (a single returned expression) was substituted at the call site
+class InlinedFunctionNode : public AbstractExpressionNode {
+	public:
+		uint32_t numArgs;
+		AbstractExpressionNode** arguments;
+		Function* function;
+		uint32_t parameters; //first slot of the argument values read by ParameterNodes in body
+		AbstractExpressionNode* body;
+
+		InlinedFunctionNode(FunctionExpressionNode* call, uint32_t parameters, AbstractExpressionNode* body);
+		ParseData evaluate();
+		std::string toString();
+};
+
+//call of a C++ function, arguments are converted to its types when it is called
+class NativeFunctionNode : public AbstractExpressionNode {
+	public:
+		uint32_t numArgs;
+		AbstractExpressionNode** arguments;
+		const NativeFunction* function;
+		char* context;
+		bool isTemporary; //a string result doesn't outlive its statement, so it can use scratch memory
+
+		NativeFunctionNode(const NativeFunction* function, AbstractExpressionNode** arguments, char* context, uint32_t startLine, uint32_t endLine);
+		ParseData evaluate();
+		std::string toString();
+};
+
+//reads a parameter of an inlined function
+class ParameterNode : public AbstractExpressionNode {
+	public:
+		std::string variable;
+		uint32_t parameter; //slot
+
+		ParameterNode(VariableNode* var, uint32_t parameter);
+		ParseData evaluate();
+		std::string toString();
+};
+
 
 ///////////////////////////////////
 ///////      Literal        ///////
@@ -201,6 +305,15 @@ class LiteralNode : public AbstractExpressionNode {
     std::string toString();
 };
 
+//class that calls a function built into the interpreter
+class BuiltinFunctionNode : public AbstractExpressionNode {
+  public:
+    BuiltinFunction function;
+    BuiltinFunctionNode(BuiltinFunction f, uint32_t startLine, uint32_t endLine);
+    ParseData evaluate();
+    std::string toString();
+};
+
 
 ///////////////////////////////////
 ///////      Grouped        ///////
@@ -215,5 +328,21 @@ class GroupedExpressionNode : public AbstractExpressionNode {
     std::string toString();
 };
 
+///////////////////////////////////
+///////   Subexpression     ///////
+///////////////////////////////////
+
+//repeated pure subexpression, the first occurrence computes and stores the value
+//and later occurrences just read it back
+class CommonSubexpressionNode : public AbstractExpressionNode {
+  public:
+    AbstractExpressionNode* expression;
+    uint32_t value; //slot
+    bool isProducer;
+    CommonSubexpressionNode(AbstractExpressionNode* exp, uint32_t value, bool isProducer);
+    ParseData evaluate();
+    std::string toString();
+};
+
 
 #endif
@@ -1,3 +1,6 @@
+#ifndef PARSER_H
+#define PARSER_H
+
 #include <vector>
 #include <cstdint>
 #include <string>
@@ -13,89 +16,119 @@ class SymbolTable;
 //////     Return Tree     //////
 /////////////////////////////////
 
-std::vector<AbstractStatementNode*>* parse(std::vector<Token>* tokens, std::vector<char*>* codeLines);
+//variables already declared in symbolTable can be used by the program without declaring them
+std::vector<AbstractStatementNode*>* parse(std::vector<Token>* tokens, std::vector<char*>* codeLines, SymbolTable* symbolTable);
 
-/////////////////////////////////
-//////    Access Tokens     /////
-/////////////////////////////////
+//state of parsing one program, so programs can be parsed one after another or on several threads at once
+class Parser {
 
-//consume a Token in the list (increment index)
-Token* consume();
+  public:
+    Parser(std::vector<Token>* tokens, std::vector<char*>* codeLines, SymbolTable* symbolTable);
+    std::vector<AbstractStatementNode*>* parse();
 
-//backtrack by 1 token in the list
-void stepBack();
+  private:
+    uint32_t tokenIndex;
+    std::vector<Token>* tokens;
+    SymbolTable* symbolTable;
+    std::vector<char*>* codeLines;
 
-//examine the current Token, don't advance position
-Token* peek();
+    //return types of the functions being parsed, checked by their return statements
+    std::vector<ParseDataType> returnType;
 
-//examine a Token at given index
-Token* peekAhead(uint32_t offset);
+    //some state variables
+    bool insideClassDefinition;
 
-char* getCodeLineBlock(uint32_t start, uint32_t end);
+    /////////////////////////////////
+    //////    Access Tokens     /////
+    /////////////////////////////////
 
+    //consume a Token in the list (increment index)
+    Token* consume();
 
-/////////////////////////////////
-//////       Helpers        /////
-/////////////////////////////////
+    //backtrack by 1 token in the list
+    void stepBack();
 
-Function* parseFunction(uint32_t startLine, uint32_t secondStartLine, std::string functionName, bool isStatement);
+    //examine the current Token, don't advance position
+    Token* peek();
 
-/////////////////////////////////
-//////    Subroutines     ///////
-/////////////////////////////////
+    //examine a Token at given index
+    Token* peekAhead(uint32_t offset);
+
+    char* getCodeLineBlock(uint32_t start, uint32_t end);
+
+
+    /////////////////////////////////
+    //////       Helpers        /////
+    /////////////////////////////////
+
+    Function* parseFunction(uint32_t startLine, uint32_t secondStartLine, std::string functionName);
+
+    //reads and typechecks the arguments of a call, up to and including the ), returns the )
+    Token* parseArguments(Token* variable, Token* leftParenToken, uint32_t numArgs, ParseDataType* argTypes, ParseDataType* argSubTypes,
+                          AbstractExpressionNode** arguments);
+
+    bool isPostfixStructure();
+    bool isCastStructure();
+    bool isPrefixStructure();
+
+    /////////////////////////////////
+    //////    Subroutines     ///////
+    /////////////////////////////////
 
-// variable, number, string, etc.
-AbstractExpressionNode* evalLiteralGroup();
+    // variable, number, string, etc.
+    AbstractExpressionNode* evalLiteralGroup();
 
-// x++ x-- x() x->stuff x.stuff
-AbstractExpressionNode* evalPostfixFunctionMembers();
+    // x[] x[:] x.stuff
+    AbstractExpressionNode* handleMemberAccess(AbstractExpressionNode* head);
 
-// ++x --x + - ! ~
-AbstractExpressionNode* evalPrefixNotCast();
+    // x++ x-- x() x->stuff x.stuff
+    AbstractExpressionNode* evalPostfixMemberAccess();
 
-// **
-AbstractExpressionNode* evalExponent();
+    // ++x --x + - ! ~ (type)
+    AbstractExpressionNode* evalPrefixCastSignNot();
 
-// * / %
-AbstractExpressionNode* evalMultiplyDivideMod();
+    // **
+    AbstractExpressionNode* evalExponent();
 
-// + -
-AbstractExpressionNode* evalAddSubtract();
+    // * / %
+    AbstractExpressionNode* evalMultiplyDivideMod();
 
-// << >>
-AbstractExpressionNode* evalBitShift();
+    // + -
+    AbstractExpressionNode* evalAddSubtract();
 
-// < <= > >=
-AbstractExpressionNode* evalComparison();
+    // << >>
+    AbstractExpressionNode* evalBitShift();
 
-// == and !=
-AbstractExpressionNode* evalEquality();
+    // < <= > >=
+    AbstractExpressionNode* evalComparison();
 
-// &
-AbstractExpressionNode* evalBitAnd();
+    // == and !=
+    AbstractExpressionNode* evalEquality();
 
-// ^
-AbstractExpressionNode* evalBitXor();
+    // &
+    AbstractExpressionNode* evalBitAnd();
 
-// |
-AbstractExpressionNode* evalBitOr();
+    // ^
+    AbstractExpressionNode* evalBitXor();
 
-// &&
-AbstractExpressionNode* evalLogicAnd();
+    // |
+    AbstractExpressionNode* evalBitOr();
 
-// ^^
-AbstractExpressionNode* evalLogicXor();
+    // &&
+    AbstractExpressionNode* evalLogicAnd();
 
-// ||
-AbstractExpressionNode* evalLogicOr();
+    // ^^
+    AbstractExpressionNode* evalLogicXor();
 
-// ? :
-AbstractExpressionNode* evalTernary();
+    // ||
+    AbstractExpressionNode* evalLogicOr();
 
-//  = += -= *= **= /= &= ^= |= <<= >>=
-AbstractExpressionNode* evalAssignment();
+    //  = += -= *= **= /= &= ^= |= <<= >>=
+    AbstractExpressionNode* evalAssignment();
 
-AbstractExpressionNode* evalExpression();
+    AbstractExpressionNode* evalExpression();
 
-AbstractStatementNode* addStatement();
+    AbstractStatementNode* addStatement();
+};
 
+#endif
@@ -51,6 +51,12 @@ enum ParseOperatorType {
   INVALID_OP
 };
 
+//represents a function that is built into the interpreter
+enum BuiltinFunction {
+  NANOTIME_FUN, CPUTIME_FUN,
+  INVALID_FUN
+};
+
 //holds type and data information
 struct ParseData {
   ParseDataType type;
@@ -70,6 +76,7 @@ ParseData copyParseData(ParseData d);
 const char* toStringParseDataType(ParseDataType p);
 const char* toStringParseOperatorType(ParseOperatorType p);
 const char* toWordParseOperatorType(ParseOperatorType p);
+const char* toStringBuiltinFunction(BuiltinFunction f);
 char* toStringParseData(ParseData d);
 
 
@@ -103,5 +110,8 @@ ParseOperatorType unaryTokenConversion(TokenType tt);
 //returns corresponding ParseDataType enum from binary operator TokenType enum
 ParseOperatorType binaryTokenConversion(TokenType tt);
 
+//returns the BuiltinFunction enum called by that name, INVALID_FUN if there is none
+BuiltinFunction nameBuiltinConversion(const char* name);
+
 #endif
 
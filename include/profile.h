@@ -0,0 +1,60 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <csignal>
+#include "metrics.h"
+
+//deeper calls are attributed to the deepest frame that fits
+#define MAX_PROFILE_DEPTH 4096
+
+//the Ash function running at one level of the call stack, and its current line
+struct ProfileFrame {
+	const char* function;
+	uint32_t line;
+};
+
+//shadow stack of the program running on this thread, kept up to date whether or not it is being profiled
+//a run starts at main, or on top of the run it is nested in, and leaves it as it found it
+extern thread_local ProfileFrame profileStack[MAX_PROFILE_DEPTH];
+extern thread_local ProfileFrame* profileTop;
+extern thread_local uint32_t profileDepth;
+
+//timer ticks not yet recorded, set by the signal handler
+extern volatile sig_atomic_t pendingSamples;
+
+void takeSample();
+
+//called as each statement starts, so samples and snapshots land on the line that was running
+inline void profileLine(uint32_t line) {
+	if(pendingSamples)
+		takeSample();
+	profileTop->line = line;
+	if(pendingMetrics)
+		dumpMetrics();
+}
+
+inline void enterProfileFrame(const char* function) {
+	if(++profileDepth < MAX_PROFILE_DEPTH) {
+		profileTop++;
+		profileTop->function = function;
+		profileTop->line = 0;
+	}
+}
+
+inline void leaveProfileFrame() {
+	if(pendingSamples)
+		takeSample();
+	if(profileDepth-- < MAX_PROFILE_DEPTH)
+		profileTop--;
+}
+
+//the source of a line without its indentation, for reports
+std::string sourceLine(std::vector<char*>* codeLines, uint32_t line);
+
+//starts sampling every intervalMicros of CPU time, the results are written when the interpreter exits
+void startProfiling(const char* sourceFile, std::vector<char*>* codeLines, const char* foldedFile, uint32_t intervalMicros);
+
+#endif
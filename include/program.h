@@ -0,0 +1,67 @@
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "token.h"
+#include "symboltable.h"
+#include "function.h"
+#include "format.h"
+#include "native.h"
+
+class AbstractExpressionNode;
+class AbstractStatementNode;
+
+//a lexed, parsed and optimized program and everything compiling it allocated, freed all together
+//running it only reads it, every run keeps its state in an ExecutionContext
+class CompiledProgram {
+
+	public:
+		std::vector<char*>* codeLines;
+		std::vector<Token> tokens;
+		SymbolTable* symbolTable; //the parser's, holds the declared globals before parsing
+		std::vector<AbstractStatementNode*>* statements;
+		uint32_t numSlots; //values the optimizer's nodes keep, see reserveSlots
+	std::vector<NativeFunction> natives; //registered with the engine, copied so calls outlive it, set before parsing
+
+		//registered as they're created, nodes are shared between trees so they can't be freed by walking them
+		//and a failed parse leaves some that no node has taken yet
+		std::vector<AbstractExpressionNode*> expressionNodes;
+		std::vector<AbstractStatementNode*> statementNodes;
+		std::vector<std::vector<AbstractExpressionNode*>*> expressionLists;
+		std::vector<std::vector<AbstractStatementNode*>*> statementLists;
+		std::vector<std::vector<FormatSpecifier>*> formatLists;
+		std::vector<void*> memory;
+
+		CompiledProgram();
+		~CompiledProgram();
+};
+
+//the program being compiled on this thread, everything created meanwhile belongs to it
+extern thread_local CompiledProgram* compilingProgram;
+
+//zeroed memory that is freed with the program being compiled
+void* allocateProgram(size_t size);
+
+//empty lists that are freed with the program being compiled
+std::vector<AbstractExpressionNode*>* newExpressionList();
+std::vector<AbstractStatementNode*>* newStatementList();
+std::vector<FormatSpecifier>* newFormatList();
+
+//makes program the one being compiled for its lifetime, heap values allocated meanwhile belong to it too
+class CompilingScope {
+
+	public:
+		CompilingScope(CompiledProgram* program);
+		~CompilingScope();
+
+	private:
+		CompiledProgram* previous;
+		std::vector<void*>* previousHeapOwner;
+};
+
+//splits source code into lines, each ending with a newline, for error messages
+std::vector<char*>* getLines(char* code);
+
+#endif
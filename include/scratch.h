@@ -0,0 +1,50 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//position in the scratch region, everything allocated after it is freed together
+struct ScratchMark {
+	uint32_t block;
+	size_t used;
+	size_t live;
+};
+
+//memory for values that never outlive the statement that created them
+ScratchMark scratchMark();
+void scratchRelease(ScratchMark mark);
+
+//bytes of scratch values that haven't been released yet
+size_t scratchLiveBytes();
+
+//allocates a string or array value, from the scratch region while a ScratchScope is active
+void* allocateValue(size_t size);
+
+//allocates memory that outlives any scratch scope
+//every runtime string and array comes from these two, so --stats and --alloc-profile see all of them
+void* allocateHeap(size_t size);
+
+//frees a heap value of size bytes that nothing else points to, and forgets it in the heap owner
+void freeHeap(void* memory, size_t size);
+
+//strings and arrays allocated on this thread from now on can take at most this many bytes, scratch values while they're live
+void setHeapLimit(size_t bytes);
+
+//heap memory allocated on this thread from now on is recorded in owner, which frees it, returns the previous owner
+//without one heap values are never freed
+std::vector<void*>* setHeapOwner(std::vector<void*>* owner);
+
+//sends allocateValue to the scratch region for its lifetime
+class ScratchScope {
+
+	public:
+		ScratchScope(bool enabled);
+		~ScratchScope();
+
+	private:
+		bool previous;
+};
+
+#endif
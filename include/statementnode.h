@@ -8,6 +8,7 @@
 #include "parsenode.h"
 #include "symboltable.h"
 #include "function.h"
+#include "format.h"
 
 //forward declarations to break cyclic dependencies with function.h and parsenode.h
 struct Function;
@@ -24,6 +25,11 @@ class AbstractStatementNode {
 		uint32_t startLine;
 		uint32_t endLine;
     SymbolTable* symbolTable;
+
+    //nodes belong to the program being compiled
+    AbstractStatementNode();
+    virtual ~AbstractStatementNode() {}
+
     virtual void execute() = 0;
   
 };
@@ -59,6 +65,19 @@ class PrintLineStatementNode : public AbstractStatementNode {
     void execute();
 };
 
+//represents printf statement, its format literal is split into specifiers while parsing
+class PrintFormattedStatementNode : public AbstractStatementNode {
+
+  public:
+    AbstractExpressionNode* format;
+    std::vector<FormatSpecifier>* specifiers;
+    uint32_t numArgs;
+    AbstractExpressionNode** arguments;
+    PrintFormattedStatementNode(AbstractExpressionNode* format, std::vector<FormatSpecifier>* specifiers, uint32_t numArgs,
+        AbstractExpressionNode** arguments, SymbolTable* symbolTable, uint32_t startLine, uint32_t endLine);
+    void execute();
+};
+
 
 //represents a group of statements in braces
 class GroupedStatementNode : public AbstractStatementNode {
@@ -95,6 +114,13 @@ class WhileStatementNode: public AbstractStatementNode {
     void execute();
 };
 
+//loop variable times a constant, updated by adding the step times that constant
+struct InductionVariable {
+  AbstractExpressionNode* product; //computes the starting value
+  uint32_t value; //slot
+  uint64_t increment;
+};
+
 //represents for loop
 class ForStatementNode: public AbstractStatementNode {
 
@@ -104,11 +130,32 @@ class ForStatementNode: public AbstractStatementNode {
     AbstractStatementNode* body;
     AbstractExpressionNode* condition;
     SymbolTable* symbolTable;
+    std::vector<InductionVariable> inductionVariables;
+
+    //arrays indexed by the loop variable, and the bound that keeps those indices in range
+    std::vector<std::string> guardedArrays;
+    AbstractExpressionNode* rangeLimit;
+    uint32_t inRange; //slot, NO_SLOT if no array is guarded
     
     ForStatementNode(AbstractStatementNode* init, AbstractStatementNode* upd, AbstractStatementNode* bod, AbstractExpressionNode* cond, SymbolTable* symbolTable, uint32_t startLine);
     void execute();
 };
 
+//runs its body a number of times after a few warm-up runs and reports how long the runs took
+class BenchStatementNode: public AbstractStatementNode {
+
+  public:
+    char* name;
+    AbstractExpressionNode* runs; //NULL if the block doesn't give its own count
+    AbstractStatementNode* body;
+
+    BenchStatementNode(char* name, AbstractExpressionNode* runs, AbstractStatementNode* body, SymbolTable* symbolTable, uint32_t startLine);
+    void execute();
+};
+
+//runs of bench blocks without their own count, and warm-up runs of every bench block
+void setBenchRuns(uint32_t runs, uint32_t warmupRuns);
+
 //represents declaration (and maybe assignment) of a new variable
 class NewAssignmentStatementNode : public AbstractStatementNode {
 	
@@ -146,6 +193,7 @@ class ArrayAssignmentStatementNode : public AbstractStatementNode {
 		AbstractExpressionNode* value;
     char* context;
     bool isArray;
+    uint32_t inRange; //slot set if the index was proven in range before the enclosing loop started, or NO_SLOT
 
 		ArrayAssignmentStatementNode(std::string variable, bool isArray, AbstractExpressionNode* index, AbstractExpressionNode* value, SymbolTable* symbolTable, char* context, uint32_t startLine);
 		void execute();
@@ -155,11 +203,10 @@ class ArrayAssignmentStatementNode : public AbstractStatementNode {
 class ReturnStatementNode : public AbstractStatementNode {
 	
 	public:
-		bool* returnFlag;
-		ParseData* returnValue;
 		AbstractExpressionNode* expression;
+		bool isTailCall; //returns a call to the enclosing function
 
-		ReturnStatementNode(AbstractExpressionNode* expression, bool* returnFlag, ParseData* returnValue, uint32_t startLine);
+		ReturnStatementNode(AbstractExpressionNode* expression, uint32_t startLine);
 		void execute();
 };
 
@@ -0,0 +1,39 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <vector>
+#include <cstdint>
+#include "statementnode.h"
+
+//parts of a run that --time reports separately
+enum Phase {READ_PHASE, LINES_PHASE, LEX_PHASE, PARSE_PHASE, OPTIMIZE_PHASE, EXECUTE_PHASE, NUM_PHASES};
+
+//ends the phase that is running (if any) and starts timing the given one
+void beginPhase(Phase phase);
+
+//counters reported by --stats, always kept since each costs one increment
+struct RunCounters {
+	uint64_t tokens;
+	uint64_t statements;
+	uint64_t scopePushes;
+	uint64_t scopePops;
+	uint64_t functionCalls;
+	uint64_t allocations;
+	uint64_t allocatedBytes;
+	uint64_t scratchAllocations;
+};
+
+extern thread_local RunCounters runCounters;
+
+//the tree whose nodes --stats counts by class
+void setReportedProgram(std::vector<AbstractStatementNode*>* statements);
+
+enum ReportFormat {NO_REPORT, TEXT_REPORT, JSON_REPORT};
+
+void setTimeReport(ReportFormat format);
+void setStatsReport(ReportFormat format);
+
+//prints the requested reports to stderr, registered with atexit so error exits are reported too
+void printReports();
+
+#endif
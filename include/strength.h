@@ -0,0 +1,10 @@
+#ifndef STRENGTH_H
+#define STRENGTH_H
+
+#include <vector>
+#include "statementnode.h"
+
+//replace powers, divisions and mods by constants and products of loop variables with cheaper operations
+void reduceStrength(std::vector<AbstractStatementNode*>* statements);
+
+#endif
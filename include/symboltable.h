@@ -16,8 +16,10 @@ class SymbolTable {
  
   public:
     SymbolTable();
+    ~SymbolTable();
     void enterNewScope();
     void leaveScope();
+    void clearScope();
     void declare(std::string var, ParseData value);
     void update(std::string var, ParseData value);
     bool isDeclaredInScope(std::string var);
@@ -0,0 +1,10 @@
+#ifndef TAILCALL_H
+#define TAILCALL_H
+
+#include <vector>
+#include "statementnode.h"
+
+//mark returns of self-calls in tail position so they reuse the running call
+void markTailCalls(std::vector<AbstractStatementNode*>* statements);
+
+#endif
@@ -38,7 +38,7 @@ enum TokenType {
 
   //Reserved Words
   FOR, WHILE, DO, IF, ELIF, ELSE, BREAK, SWITCH, CASE,
-  CLASS, EXTENDS, FUN, RETURN, NEW, PRINT, PRINTLN,
+  CLASS, EXTENDS, FUN, RETURN, NEW, PRINT, PRINTLN, PRINTF, BENCH,
 
   TRUE, FALSE,
 
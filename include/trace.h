@@ -0,0 +1,17 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+
+//set by --trace, spans are then kept in memory and written out as Chrome trace events on exit
+extern bool tracing;
+
+//nanoseconds from a monotonic clock, taken when a span starts
+uint64_t traceClock();
+
+//records a span from start until now, dropped once the buffer holds the maximum number of events
+void traceSpan(const char* name, const char* category, uint64_t start, uint32_t line);
+
+void startTracing(const char* traceFile, uint32_t maxEvents);
+
+#endif
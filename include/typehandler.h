@@ -27,4 +27,6 @@ ParseDataType getTypeBitLogicalExpression(ParseOperatorType op, ParseDataType l,
 
 ParseDataType getTypeComparisonExpression(ParseOperatorType op, ParseDataType l, ParseDataType r);
 
+ParseDataType getTypeBuiltinFunctionExpression(BuiltinFunction f);
+
 #endif
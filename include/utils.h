@@ -8,6 +8,9 @@
 //allocate a char* copy of a string
 char* copyString(const char* str);
 
+//terminate a number formatted into text and allocate a copy of it
+char* copyNumber(char* text, uint32_t length);
+
 //allocate a char* subtring
 char* copySubstring(const char* str, int32_t start, int32_t pastEnd);
 
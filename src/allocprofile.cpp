@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "scratch.h"
+#include "stats.h"
+#include "profile.h"
+#include "allocprofile.h"
+
+//rows of the report
+#define ALLOC_TABLE_LINES 20
+
+bool allocProfiling = false;
+
+struct LineAllocations {
+	const char* function;
+	uint64_t allocations;
+	uint64_t bytes;
+	uint64_t scratchBytes;
+};
+
+static std::vector<char*>* profiledLines;
+static const char* reportFile;
+
+static std::map<uint32_t, LineAllocations> lines;
+static uint64_t allocations = 0;
+static uint64_t bytes = 0;
+static uint64_t scratchBytes = 0;
+
+//values are never freed, so everything from the heap stays live until the interpreter exits, except temporaries given to freeHeap
+static uint64_t heapBytes;
+static uint64_t parseBytes;
+
+static uint64_t peakLive = 0;
+static uint32_t peakLine = 0;
+static const char* peakFunction = "<main>";
+
+void recordAllocation(size_t size, bool scratch) {
+
+	LineAllocations& line = lines[profileTop->line];
+	line.function = profileTop->function;
+	line.allocations++;
+	line.bytes += size;
+
+	allocations++;
+	bytes += size;
+
+	if(scratch) {
+		line.scratchBytes += size;
+		scratchBytes += size;
+	} else {
+		heapBytes += size;
+	}
+
+	uint64_t live = heapBytes + scratchLiveBytes();
+	if(live > peakLive) {
+		peakLive = live;
+		peakLine = profileTop->line;
+		peakFunction = profileTop->function;
+	}
+}
+
+void recordFree(size_t size) {
+	heapBytes -= size;
+}
+
+static bool moreBytes(const std::pair<uint32_t, LineAllocations>& a, const std::pair<uint32_t, LineAllocations>& b) {
+	if(a.second.bytes != b.second.bytes)
+		return a.second.bytes > b.second.bytes;
+	return a.first < b.first;
+}
+
+static void writeReport(FILE* out) {
+
+	std::vector<std::pair<uint32_t, LineAllocations> > sorted(lines.begin(), lines.end());
+	std::sort(sorted.begin(), sorted.end(), moreBytes);
+
+	fprintf(out, "alloc profile: %llu allocations of %llu bytes while running, %llu of them from the scratch region\n",
+		(unsigned long long) allocations, (unsigned long long) bytes, (unsigned long long) scratchBytes);
+	fprintf(out, "peak live heap: %llu bytes at line %u (%s), %llu of them allocated before running\n",
+		(unsigned long long) peakLive, peakLine, peakFunction, (unsigned long long) parseBytes);
+
+	if(allocations == 0)
+		return;
+
+	fprintf(out, "%14s %7s %12s %9s %6s  %-16s %s\n", "bytes", "bytes %", "allocations", "scratch %", "line", "function", "source");
+
+	for(uint32_t i = 0; i < sorted.size() && i < ALLOC_TABLE_LINES; i++) {
+		LineAllocations& line = sorted[i].second;
+		fprintf(out, "%14llu %7.1f %12llu %9.1f %6u  %-16s %s\n", (unsigned long long) line.bytes, 100.0 * line.bytes / bytes,
+			(unsigned long long) line.allocations, (line.bytes != 0) ? 100.0 * line.scratchBytes / line.bytes : 0.0,
+			sorted[i].first, line.function, sourceLine(profiledLines, sorted[i].first).c_str());
+	}
+}
+
+static void finishAllocProfile() {
+
+	allocProfiling = false;
+
+	if(reportFile == NULL) {
+		writeReport(stderr);
+		return;
+	}
+
+	FILE* out = fopen(reportFile, "w");
+	if(out == NULL) {
+		fprintf(stderr, "Couldn't write the alloc profile to %s: %s\n", reportFile, strerror(errno));
+		return;
+	}
+
+	writeReport(out);
+	fclose(out);
+}
+
+void startAllocProfiling(std::vector<char*>* codeLines, const char* file) {
+
+	profiledLines = codeLines;
+	reportFile = file;
+
+	//the token text and literals the parser kept
+	parseBytes = heapBytes = peakLive = runCounters.allocatedBytes;
+
+	allocProfiling = true;
+	atexit(finishAllocProfile);
+}
@@ -9,7 +9,11 @@
 #include "parsetoken.h"
 #include "parsenode.h"
 #include "casteval.h"
+#include "arithmeticeval.h"
+#include "scratch.h"
 #include "array.h"
+#include "numconv.h"
+#include "counters.h"
 
 
 //helper template functions used to handle operations
@@ -206,7 +210,7 @@ ParseData additionHelper<char*, unsigned char>(char* n1, unsigned char n2, Parse
   unsigned char arg2 = (unsigned char) n2;
   uint32_t len = strlen(arg1);
   
-  char* res = new char[len+2];
+  char* res = (char*) allocateValue(len+2);
   res[0] = '\0';
   strncat(res, arg1, len);
   res[len] = arg2; res[len+1] = '\0';
@@ -227,7 +231,7 @@ ParseData additionHelper<bool, char*>(bool n1, char* n2, ParseDataType type) {
   uint32_t len1 = strlen(arg1Str);
   uint32_t len2 = strlen(arg2);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1Str, len1);
   strncat(res, arg2, len2);
@@ -249,7 +253,7 @@ ParseData additionHelper<char*, bool>(char* n1, bool n2, ParseDataType type) {
   uint32_t len1 = strlen(arg1);
   uint32_t len2 = strlen(arg2Str);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1, len1);
   strncat(res, arg2Str, len2);
@@ -267,11 +271,12 @@ ParseData additionHelper<char*, int32_t>(char* n1, int32_t n2, ParseDataType typ
 
   char* arg1 = (char*) n1;
   int32_t arg2 = (int32_t) n2;
-  const char* arg2Str = std::to_string(arg2).c_str();
+  char arg2Str[MAX_NUMBER_LENGTH + 1];
+  arg2Str[formatSigned(arg2, arg2Str)] = '\0';
   uint32_t len1 = strlen(arg1);
   uint32_t len2 = strlen(arg2Str);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1, len1);
   strncat(res, arg2Str, len2);
@@ -289,11 +294,12 @@ ParseData additionHelper<char*, int64_t>(char* n1, int64_t n2, ParseDataType typ
 
   char* arg1 = (char*) n1;
   int64_t arg2 = (int64_t) n2;
-  const char* arg2Str = std::to_string(arg2).c_str();
+  char arg2Str[MAX_NUMBER_LENGTH + 1];
+  arg2Str[formatSigned(arg2, arg2Str)] = '\0';
   uint32_t len1 = strlen(arg1);
   uint32_t len2 = strlen(arg2Str);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1, len1);
   strncat(res, arg2Str, len2);
@@ -311,11 +317,12 @@ ParseData additionHelper<char*, uint32_t>(char* n1, uint32_t n2, ParseDataType t
 
   char* arg1 = (char*) n1;
   uint32_t arg2 = (uint32_t) n2;
-  const char* arg2Str = std::to_string(arg2).c_str();
+  char arg2Str[MAX_NUMBER_LENGTH + 1];
+  arg2Str[formatUnsigned(arg2, arg2Str)] = '\0';
   uint32_t len1 = strlen(arg1);
   uint32_t len2 = strlen(arg2Str);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1, len1);
   strncat(res, arg2Str, len2);
@@ -333,11 +340,12 @@ ParseData additionHelper<char*, uint64_t>(char* n1, uint64_t n2, ParseDataType t
 
   char* arg1 = (char*) n1;
   uint64_t arg2 = (uint64_t) n2;
-  const char* arg2Str = std::to_string(arg2).c_str();
+  char arg2Str[MAX_NUMBER_LENGTH + 1];
+  arg2Str[formatUnsigned(arg2, arg2Str)] = '\0';
   uint32_t len1 = strlen(arg1);
   uint32_t len2 = strlen(arg2Str);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1, len1);
   strncat(res, arg2Str, len2);
@@ -355,11 +363,12 @@ ParseData additionHelper<char*, double>(char* n1, double n2, ParseDataType type)
 
   char* arg1 = (char*) n1;
   double arg2 = (double) n2;
-  const char* arg2Str = std::to_string(arg2).c_str();
+  char arg2Str[MAX_NUMBER_LENGTH + 1];
+  arg2Str[formatDouble(arg2, arg2Str)] = '\0';
   uint32_t len1 = strlen(arg1);
   uint32_t len2 = strlen(arg2Str);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1, len1);
   strncat(res, arg2Str, len2);
@@ -380,7 +389,7 @@ ParseData additionHelper<char*, char*>(char* n1, char* n2, ParseDataType type) {
   uint32_t len1 = strlen(arg1);
   uint32_t len2 = strlen(arg2);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1, len1);
   strncat(res, arg2, len2);
@@ -400,7 +409,7 @@ ParseData additionHelper<unsigned char, char*>(unsigned char n1, char* n2, Parse
   char* arg2 = (char*) n2;
   uint32_t len = strlen(arg2);
   
-  char* res = new char[len+2];
+  char* res = (char*) allocateValue(len+2);
   res[0] = arg1; res[1] = '\0';
   strncat(res, arg2, len);
   res[len+1] = '\0';
@@ -416,12 +425,13 @@ template<>
 ParseData additionHelper<int32_t, char*>(int32_t n1, char* n2, ParseDataType type) {
 
   int32_t arg1 = (int32_t) n1;
-  const char* arg1Str = std::to_string(arg1).c_str();
+  char arg1Str[MAX_NUMBER_LENGTH + 1];
+  arg1Str[formatSigned(arg1, arg1Str)] = '\0';
   char* arg2 = (char*) n2;
   uint32_t len1 = strlen(arg1Str);
   uint32_t len2 = strlen(arg2);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1Str, len1);
   strncat(res, arg2, len2);
@@ -438,12 +448,13 @@ template<>
 ParseData additionHelper<int64_t, char*>(int64_t n1, char* n2, ParseDataType type) {
 
   int64_t arg1 = (int64_t) n1;
-  const char* arg1Str = std::to_string(arg1).c_str();
+  char arg1Str[MAX_NUMBER_LENGTH + 1];
+  arg1Str[formatSigned(arg1, arg1Str)] = '\0';
   char* arg2 = (char*) n2;
   uint32_t len1 = strlen(arg1Str);
   uint32_t len2 = strlen(arg2);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1Str, len1);
   strncat(res, arg2, len2);
@@ -460,12 +471,13 @@ template<>
 ParseData additionHelper<uint32_t, char*>(uint32_t n1, char* n2, ParseDataType type) {
 
   uint32_t arg1 = (uint32_t) n1;
-  const char* arg1Str = std::to_string(arg1).c_str();
+  char arg1Str[MAX_NUMBER_LENGTH + 1];
+  arg1Str[formatUnsigned(arg1, arg1Str)] = '\0';
   char* arg2 = (char*) n2;
   uint32_t len1 = strlen(arg1Str);
   uint32_t len2 = strlen(arg2);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1Str, len1);
   strncat(res, arg2, len2);
@@ -482,12 +494,13 @@ template<>
 ParseData additionHelper<uint64_t, char*>(uint64_t n1, char* n2, ParseDataType type) {
 
   uint64_t arg1 = (uint64_t) n1;
-  const char* arg1Str = std::to_string(arg1).c_str();
+  char arg1Str[MAX_NUMBER_LENGTH + 1];
+  arg1Str[formatUnsigned(arg1, arg1Str)] = '\0';
   char* arg2 = (char*) n2;
   uint32_t len1 = strlen(arg1Str);
   uint32_t len2 = strlen(arg2);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1Str, len1);
   strncat(res, arg2, len2);
@@ -504,12 +517,13 @@ template<>
 ParseData additionHelper<double, char*>(double n1, char* n2, ParseDataType type) {
 
   double arg1 = (double) n1;
-  const char* arg1Str = std::to_string(arg1).c_str();
+  char arg1Str[MAX_NUMBER_LENGTH + 1];
+  arg1Str[formatDouble(arg1, arg1Str)] = '\0';
   char* arg2 = (char*) n2;
   uint32_t len1 = strlen(arg1Str);
   uint32_t len2 = strlen(arg2);
   
-  char* res = new char[len1+len2+1];
+  char* res = (char*) allocateValue(len1+len2+1);
   res[0] = '\0';
   strncat(res, arg1Str, len1);
   strncat(res, arg2, len2);
@@ -535,7 +549,7 @@ ParseData additionHelper<Array*, Array*>(Array* a1, Array* a2, ParseDataType typ
 
 	uint32_t length = len1 + len2;
 	ParseDataType finalType = getTypeArithmeticExpression(ADD_OP, type1, type2);
-	ParseData* values = (ParseData*) malloc(sizeof(ParseData) * length);
+	ParseData* values = (ParseData*) allocateValue(sizeof(ParseData) * length);
 
 	for(uint32_t i = 0; i < len1; i++) {
 		values[i] = castHelper(values1[i], finalType);
@@ -545,7 +559,7 @@ ParseData additionHelper<Array*, Array*>(Array* a1, Array* a2, ParseDataType typ
 		values[i+len1] = castHelper(values2[i], finalType);
 	}
 
-	Array* arr = (Array*) malloc(sizeof(Array));
+	Array* arr = (Array*) allocateValue(sizeof(Array));
 	arr->length = length;
 	arr->subtype = finalType;
 	arr->values = values;
@@ -558,17 +572,24 @@ ParseData additionHelper<Array*, Array*>(Array* a1, Array* a2, ParseDataType typ
 }
 
 
-//actual evaluating function, handles all operator
-//and numeric data type cases
 ParseData evaluateArithmeticExpression(ArithmeticOperatorNode* node) {
   
   //left and right arguments (calculated recursively)
   ParseData left = node->leftArg->evaluate();
   ParseData right = node->rightArg->evaluate();
+  COUNT_OPERATION(node->operation, left.type, right.type);
+
+  ScratchScope scope(node->isTemporary);
+  return arithmeticOperation(node->operation, left, right);
+}
+
+//actual evaluating function, handles all operator
+//and numeric data type cases
+ParseData arithmeticOperation(ParseOperatorType operation, ParseData left, ParseData right) {
 	
   ParseData d;
 
-  switch(node->operation) {
+  switch(operation) {
     
     ////////////////////////////////
     ///////     Exponent     ///////
@@ -855,11 +876,11 @@ ParseData evaluateArithmeticExpression(ArithmeticOperatorNode* node) {
 				ParseData* values = arr->values;
 
 				//copy into a new Array
-				Array* arr2 = (Array*) malloc(sizeof(Array));
+				Array* arr2 = (Array*) allocateValue(sizeof(Array));
 				arr2->length = length * val;
 				arr2->subtype = type;
 				
-				ParseData* values2 = (ParseData*) malloc(sizeof(ParseData) * length * val);
+				ParseData* values2 = (ParseData*) allocateValue(sizeof(ParseData) * length * val);
 
 				for(uint32_t i = 0; i < length*val; i++) {
 					uint32_t curr = i % length;
@@ -978,7 +999,7 @@ ParseData evaluateArithmeticExpression(ArithmeticOperatorNode* node) {
 
         uint64_t len = strlen(str);
         uint64_t finalLen = len*val;
-        char* c = new char[finalLen + 1];
+        char* c = (char*) allocateValue(finalLen + 1);
         c[0] = '\0';
 
         for(uint64_t i = 0; i < val; i++) {
@@ -991,7 +1012,7 @@ ParseData evaluateArithmeticExpression(ArithmeticOperatorNode* node) {
         //if val is negative, reverse the string
         if(rev) {
           
-          char* c2 = new char[finalLen + 1];
+          char* c2 = (char*) allocateValue(finalLen + 1);
           for(uint64_t i = 0; i < finalLen; i++) {
             c2[i] = c[finalLen-1-i];
           } 
@@ -1374,4 +1395,271 @@ ParseData evaluateArithmeticExpression(ArithmeticOperatorNode* node) {
   }
 
   return d;
-}
\ No newline at end of file
+}
+
+////////////////////////////////
+////  String Concatenation  ////
+////////////////////////////////
+
+bool isStringConcatenation(AbstractExpressionNode* node) {
+
+  if(GroupedExpressionNode* n = dynamic_cast<GroupedExpressionNode*>(node))
+    return isStringConcatenation(n->closedExpression);
+
+  ArithmeticOperatorNode* n = dynamic_cast<ArithmeticOperatorNode*>(node);
+  return n != NULL && n->operation == ADD_OP && n->evalType == STRING_T;
+}
+
+//evaluates the original chain one + at a time, on operands that were already evaluated
+static ParseData replayConcatenation(AbstractExpressionNode* node, ParseData* values, uint32_t& next) {
+
+  if(!isStringConcatenation(node))
+    return values[next++];
+
+  if(GroupedExpressionNode* n = dynamic_cast<GroupedExpressionNode*>(node))
+    return replayConcatenation(n->closedExpression, values, next);
+
+  ArithmeticOperatorNode* n = (ArithmeticOperatorNode*) node;
+  ParseData left = replayConcatenation(n->leftArg, values, next);
+  ParseData right = replayConcatenation(n->rightArg, values, next);
+
+  return arithmeticOperation(ADD_OP, left, right);
+}
+
+//types that + knows how to append to a string
+static bool isConcatenable(ParseDataType type) {
+  return type == STRING_T || type == BOOL_T || type == CHAR_T || type == INT32_T || type == INT64_T
+      || type == UINT32_T || type == UINT64_T || type == DOUBLE_T;
+}
+
+//number of chars the value takes up when concatenated (same text as toStringParseData)
+static uint32_t concatenatedLength(ParseData d) {
+
+  switch(d.type) {
+    case STRING_T: return strlen((char*) d.value.allocated);
+    case BOOL_T: return d.value.integer ? 4 : 5;
+
+    //appending a null char ends the string right there, so it adds nothing
+    case CHAR_T: return ((unsigned char) d.value.integer == 0) ? 0 : 1;
+
+    case INT32_T: {
+      int32_t val = (int32_t) d.value.integer;
+      return (val < 0) ? decimalLength(-(uint64_t) (int64_t) val) + 1 : decimalLength(val);
+    }
+    case INT64_T: {
+      int64_t val = (int64_t) d.value.integer;
+      return (val < 0) ? decimalLength(-(uint64_t) val) + 1 : decimalLength(val);
+    }
+    case UINT32_T: return decimalLength((uint32_t) d.value.integer);
+    case UINT64_T: return decimalLength((uint64_t) d.value.integer);
+
+    case DOUBLE_T: {
+      char text[MAX_NUMBER_LENGTH];
+      return formatDouble(d.value.floatingPoint, text);
+    }
+  }
+
+  return 0;
+}
+
+//writes the value's text and returns the position right after it
+static char* writeConcatenated(char* out, ParseData d, uint32_t length) {
+
+  switch(d.type) {
+    case STRING_T: memcpy(out, d.value.allocated, length); break;
+    case BOOL_T: memcpy(out, d.value.integer ? "true" : "false", length); break;
+    case CHAR_T: if(length != 0) *out = (char) d.value.integer; break;
+
+    case INT32_T: formatSigned((int32_t) d.value.integer, out); break;
+    case INT64_T: formatSigned((int64_t) d.value.integer, out); break;
+    case UINT32_T: formatUnsigned((uint32_t) d.value.integer, out); break;
+    case UINT64_T: formatUnsigned((uint64_t) d.value.integer, out); break;
+    case DOUBLE_T: formatDouble(d.value.floatingPoint, out); break;
+  }
+
+  return out + length;
+}
+
+ParseData evaluateConcatenationExpression(ConcatenationNode* node) {
+
+  uint32_t numOperands = node->numOperands;
+  ParseData values[numOperands];
+  uint32_t lengths[numOperands];
+  bool isConcatenation = true;
+
+  for(uint32_t i = 0; i < numOperands; i++) {
+    values[i] = node->operands[i]->evaluate();
+
+    //a string operand that turned out to be something else (e.g. an uncast parameter)
+    //could make one of the + an arithmetic addition
+    ParseDataType type = values[i].type;
+    if((node->operands[i]->evalType == STRING_T && type != STRING_T) || !isConcatenable(type))
+      isConcatenation = false;
+  }
+
+  ScratchScope scope(node->isTemporary);
+
+  if(!isConcatenation) {
+    uint32_t next = 0;
+    return replayConcatenation(node->expression, values, next);
+  }
+
+  //size the result once, then format every operand straight into it
+  uint64_t length = 0;
+  for(uint32_t i = 0; i < numOperands; i++) {
+    lengths[i] = concatenatedLength(values[i]);
+    length += lengths[i];
+  }
+
+  char* res = (char*) allocateValue(length + 1);
+  char* out = res;
+  for(uint32_t i = 0; i < numOperands; i++)
+    out = writeConcatenated(out, values[i], lengths[i]);
+  *out = '\0';
+
+  ParseData d;
+  d.type = STRING_T;
+  d.value.allocated = (void*) res;
+  return d;
+}
+
+////////////////////////////////
+////   Strength Reduction   ////
+////////////////////////////////
+
+//exact integer powers are computed by multiplication, which gives the same double
+//as pow() as long as the result stays within the 53-bit mantissa
+ParseData evaluateIntegerPowerExpression(IntegerPowerNode* node) {
+
+  ParseData base = node->base->evaluate();
+  uint32_t exponent = (uint32_t) node->exponent.value.integer;
+
+  ParseData d;
+  d.type = DOUBLE_T;
+
+  if(base.type == DOUBLE_T) {
+
+    //a single rounding, just like pow
+    double x = base.value.floatingPoint;
+    if(exponent <= 2) {
+      d.value.floatingPoint = (exponent == 0) ? 1.0 : (exponent == 1) ? x : x*x;
+      return d;
+    }
+
+    return arithmeticOperation(EXPONENT_OP, base, node->exponent);
+  }
+
+  //magnitude and sign of the integer base
+  uint64_t magnitude;
+  bool negative = false;
+
+  switch(base.type) {
+    case CHAR_T: magnitude = (unsigned char) base.value.integer; break;
+    case UINT32_T: magnitude = (uint32_t) base.value.integer; break;
+    case UINT64_T: magnitude = (uint64_t) base.value.integer; break;
+    case INT32_T: {
+      int64_t val = (int32_t) base.value.integer;
+      negative = val < 0;
+      magnitude = negative ? -(uint64_t) val : val;
+      break;
+    }
+    case INT64_T: {
+      int64_t val = (int64_t) base.value.integer;
+      negative = val < 0;
+      magnitude = negative ? -(uint64_t) val : (uint64_t) val;
+      break;
+    }
+    default: return arithmeticOperation(EXPONENT_OP, base, node->exponent);
+  }
+
+  const uint64_t limit = (uint64_t) 1 << 53;
+  uint64_t result = 1;
+
+  for(uint32_t i = 0; i < exponent; i++) {
+
+    //too large to be exact, let pow() round it
+    if(magnitude != 0 && result > limit / magnitude)
+      return arithmeticOperation(EXPONENT_OP, base, node->exponent);
+
+    result *= magnitude;
+  }
+
+  d.value.floatingPoint = (negative && (exponent & 1)) ? -(double) result : (double) result;
+  return d;
+}
+
+//division and modulo by a positive int constant, following the usual arithmetic
+//conversions (and result types) of divisionHelper and modHelper
+ParseData evaluateConstantDivisionExpression(ConstantDivisionNode* node) {
+
+  ParseData left = node->dividend->evaluate();
+  bool isDivision = node->operation == DIVIDE_OP;
+  uint64_t divisor = (uint32_t) node->divisor.value.integer;
+  uint32_t shift = node->shift;
+
+  ParseData d;
+
+  switch(left.type) {
+
+    //char is promoted to int and uint32 meets an int, so both divide as unsigned 32-bit values
+    case CHAR_T:
+    case UINT32_T: {
+
+      uint32_t a = (left.type == CHAR_T) ? (unsigned char) left.value.integer : (uint32_t) left.value.integer;
+      uint32_t q;
+
+      if(node->isPowerOfTwo) {
+        q = a >> shift;
+      } else {
+        q = (uint32_t) (((unsigned __int128) node->multiplier * a) >> 64);
+      }
+
+      d.type = INT32_T;
+      d.value.integer = (int32_t) (isDivision ? q : a - q*divisor);
+      return d;
+    }
+
+    case INT32_T: {
+
+      int64_t a = (int32_t) left.value.integer;
+      int64_t q;
+
+      if(node->isPowerOfTwo) {
+        //round toward zero, like the division instruction
+        q = (a + ((a >> 63) & (int64_t) (divisor-1))) >> shift;
+      } else {
+        uint32_t magnitude = (a < 0) ? (uint32_t) -a : (uint32_t) a;
+        uint32_t mq = (uint32_t) (((unsigned __int128) node->multiplier * magnitude) >> 64);
+        q = (a < 0) ? -(int64_t) mq : mq;
+      }
+
+      d.type = INT32_T;
+      d.value.integer = (int32_t) (isDivision ? q : a - q*(int64_t) divisor);
+      return d;
+    }
+
+    case INT64_T: {
+
+      int64_t a = (int64_t) left.value.integer;
+      int64_t q = node->isPowerOfTwo ? (a + ((a >> 63) & (int64_t) (divisor-1))) >> shift :
+                                       a / (int64_t) divisor;
+
+      d.type = INT64_T;
+      d.value.integer = isDivision ? q : a - q*(int64_t) divisor;
+      return d;
+    }
+
+    //uint64 meeting an int divides as unsigned but is typed as int64
+    case UINT64_T: {
+
+      uint64_t a = (uint64_t) left.value.integer;
+      uint64_t q = node->isPowerOfTwo ? a >> shift : a / divisor;
+
+      d.type = INT64_T;
+      d.value.integer = (int64_t) (isDivision ? q : a - q*divisor);
+      return d;
+    }
+
+    default: return arithmeticOperation(node->operation, left, node->divisor);
+  }
+}
@@ -3,6 +3,7 @@
 #include "parsenode.h"
 #include "array.h"
 #include "arrayeval.h"
+#include "scratch.h"
 
 ParseData evaluateArrayExpression(ArrayNode* node) {
 
@@ -13,11 +14,11 @@ ParseData evaluateArrayExpression(ArrayNode* node) {
 	AbstractExpressionNode** elements = node->values;
 
 	//construct the array
-	Array* arr = (Array*) malloc(sizeof(Array));
+	Array* arr = (Array*) allocateHeap(sizeof(Array));
 	arr->subtype = subtype;
 	arr->length = length;
 	
-	ParseData* values = (ParseData*) malloc(sizeof(ParseData) * length);
+	ParseData* values = (ParseData*) allocateHeap(sizeof(ParseData) * length);
 	
 	//if the array is initialized, fill it accordingly
 	if(isInitialized) {
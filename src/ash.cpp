@@ -0,0 +1,246 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include "token.h"
+#include "lexer.h"
+#include "parser.h"
+#include "parsetoken.h"
+#include "statementnode.h"
+#include "symboltable.h"
+#include "optimizer.h"
+#include "casteval.h"
+#include "utils.h"
+#include "scratch.h"
+#include "output.h"
+#include "context.h"
+#include "program.h"
+#include "native.h"
+#include "ash.h"
+
+namespace ash {
+
+Error::Error(const std::string& message) : std::runtime_error(message) {}
+
+///////////////////////////////////
+///////       Globals       ///////
+///////////////////////////////////
+
+void Globals::set(const std::string& name, int32_t value) {
+	set(name, (int64_t) value);
+}
+
+void Globals::set(const std::string& name, int64_t value) {
+	Value& v = values[name];
+	v.type = INT64_T;
+	v.integer = value;
+}
+
+void Globals::set(const std::string& name, double value) {
+	Value& v = values[name];
+	v.type = DOUBLE_T;
+	v.floatingPoint = value;
+}
+
+void Globals::set(const std::string& name, bool value) {
+	Value& v = values[name];
+	v.type = BOOL_T;
+	v.integer = value;
+}
+
+void Globals::set(const std::string& name, const char* value) {
+	set(name, std::string(value));
+}
+
+void Globals::set(const std::string& name, const std::string& value) {
+	Value& v = values[name];
+	v.type = STRING_T;
+	v.string = value;
+}
+
+///////////////////////////////////
+///////       Program       ///////
+///////////////////////////////////
+
+Program::Program(CompiledProgram* program, const std::vector<std::pair<std::string, ParseDataType> >& globals) {
+	this->program = program;
+	this->globals = globals;
+}
+
+Program::~Program() {
+	delete program;
+}
+
+void Program::run(std::string& output, const Globals& values) const {
+
+	//anything printed before on this thread still goes where it was going
+	flushOutput();
+
+	ExecutionContext context(program->numSlots);
+	ExecutionContext* previousContext = runningContext;
+	runningContext = &context;
+	std::vector<void*>* previousHeapOwner = setHeapOwner(&context.heap);
+	std::string* previousCapture = captureOutput(&output);
+	ScratchMark mark = scratchMark();
+
+	std::string error;
+
+	try {
+		for(std::map<std::string, Globals::Value>::const_iterator it = values.values.begin(); it != values.values.end(); it++) {
+			bool declared = false;
+			for(uint32_t i = 0; i < globals.size(); i++)
+				declared |= (globals[i].first == it->first);
+			if(!declared)
+				throw Error("No global named " + it->first + " was declared");
+		}
+
+		//strings are allocated by the run, so they're freed with it
+		for(uint32_t i = 0; i < globals.size(); i++) {
+
+			ParseData d;
+			d.type = globals[i].second;
+			d.value.integer = 0;
+			if(d.type == STRING_T)
+				d.value.allocated = (void*) copyString("");
+
+			std::map<std::string, Globals::Value>::const_iterator given = values.values.find(globals[i].first);
+			if(given != values.values.end()) {
+				ParseData orig;
+				orig.type = given->second.type;
+				switch(orig.type) {
+					case DOUBLE_T: orig.value.floatingPoint = given->second.floatingPoint; break;
+					case STRING_T: orig.value.allocated = (void*) copyString(given->second.string.c_str()); break;
+					default: orig.value.integer = given->second.integer; break;
+				}
+				d = (orig.type == d.type) ? orig : castHelper(orig, d.type);
+			}
+
+			context.variables.declare(globals[i].first, d);
+		}
+
+		for(uint32_t i = 0; i < program->statements->size(); i++) {
+			(*program->statements)[i]->execute();
+			scratchRelease(mark);
+		}
+	} catch(std::exception& e) {
+		error = e.what();
+	}
+
+	flushOutput();
+	scratchRelease(mark);
+	captureOutput(previousCapture);
+	setHeapOwner(previousHeapOwner);
+	runningContext = previousContext;
+
+	if(!error.empty())
+		throw Error(error);
+}
+
+std::string Program::run(const Globals& globals) const {
+	std::string output;
+	run(output, globals);
+	return output;
+}
+
+///////////////////////////////////
+///////       Engine        ///////
+///////////////////////////////////
+
+Engine::Engine() {
+	options = defaultOptimizerOptions();
+}
+
+Engine::Engine(OptimizerOptions options) {
+	this->options = options;
+}
+
+void Engine::declareGlobal(const std::string& name, ParseDataType type) {
+
+	switch(type) {
+		case BOOL_T: case CHAR_T: case DOUBLE_T: case STRING_T:
+		case INT32_T: case INT64_T: case UINT32_T: case UINT64_T:
+			break;
+		default:
+			throw Error(std::string("A global can't have type ") + toStringParseDataType(type));
+	}
+
+	globals.push_back(std::make_pair(name, type));
+}
+
+void Engine::registerNative(const std::string& name, ParseDataType returnType, const std::vector<ParseDataType>& argTypes, NativeCallback call) {
+
+	if(!isNativeParseDataType(returnType, true))
+		throw Error(std::string("A native function can't return ") + toStringParseDataType(returnType));
+	for(uint32_t i = 0; i < argTypes.size(); i++) {
+		if(!isNativeParseDataType(argTypes[i], false))
+			throw Error(std::string("A native function can't take ") + toStringParseDataType(argTypes[i]));
+	}
+
+	NativeFunction native;
+	native.name = name;
+	native.argTypes = argTypes;
+	native.returnType = returnType;
+	native.call = call;
+
+	//registering a name again replaces the function
+	for(uint32_t i = 0; i < natives.size(); i++) {
+		if(natives[i].name == name) {
+			natives[i] = native;
+			return;
+		}
+	}
+	natives.push_back(native);
+}
+
+Program* Engine::compile(const std::string& source) const {
+
+	CompiledProgram* program = new CompiledProgram();
+	std::vector<char> code(source.begin(), source.end());
+	code.push_back('\0');
+
+	std::string error;
+
+	{
+		CompilingScope compiling(program);
+
+		try {
+			program->codeLines = getLines(&code[0]);
+			program->tokens = lex(&code[0], program->codeLines);
+
+			//globals are declared like variables of the outermost scope
+			program->natives = natives;
+			program->symbolTable = new SymbolTable();
+			for(uint32_t i = 0; i < globals.size(); i++) {
+				ParseData d;
+				d.type = globals[i].second;
+				program->symbolTable->declare(globals[i].first, d);
+			}
+
+			program->statements = parse(&program->tokens, program->codeLines, program->symbolTable);
+			optimize(program->statements, options);
+		} catch(std::exception& e) {
+			error = e.what();
+		}
+	}
+
+	if(!error.empty()) {
+		delete program;
+		throw Error(error);
+	}
+
+	return new Program(program, globals);
+}
+
+Program* Engine::compileFile(const std::string& path) const {
+
+	std::ifstream in(path.c_str());
+	if(!in)
+		throw Error("Couldn't read " + path);
+
+	std::stringstream source;
+	source << in.rdbuf();
+	return compile(source.str());
+}
+
+}
@@ -8,6 +8,7 @@
 #include "parsetoken.h"
 #include "parsenode.h"
 #include "symboltable.h"
+#include "context.h"
 #include "casteval.h"
 #include "array.h"
 #include "utils.h"
@@ -17,7 +18,7 @@
 ParseData evaluateAssignmentExpression(AssignmentExpressionNode* node) {
 
   //get stuff out of the node first
-  SymbolTable* symbolTable = node->symbolTable;
+  SymbolTable* symbolTable = &runningContext->variables;
   std::string variable = node->variable;
   AbstractExpressionNode* value = node->value;
   
@@ -33,7 +34,7 @@ ParseData evaluateAssignmentExpression(AssignmentExpressionNode* node) {
 ParseData evaluateArrayAssignmentExpression(ArrayAssignmentExpressionNode* node) {
 
 	//extract instance fields
-	SymbolTable* symbolTable = node->symbolTable;
+	SymbolTable* symbolTable = &runningContext->variables;
 	int32_t index = (int32_t) node->index->evaluate().value.integer;
 
 	if(node->array->evalType == ARRAY_T) {
@@ -5,6 +5,7 @@
 #include "typehandler.h"
 #include "parsetoken.h"
 #include "parsenode.h"
+#include "counters.h"
 
 //generic helper functions (to keep code concise)
 template<typename T1, typename T2>
@@ -97,6 +98,7 @@ ParseData evaluateBitLogicalExpression(BitLogicalOperatorNode* node) {
 
   ParseData left = node->leftArg->evaluate();
   ParseData right = node->rightArg->evaluate();
+  COUNT_OPERATION(node->operation, left.type, right.type);
   
   switch(node->operation) {
     
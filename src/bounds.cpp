@@ -0,0 +1,205 @@
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "statementnode.h"
+#include "function.h"
+#include "optimizer.h"
+#include "bounds.h"
+#include "context.h"
+
+static bool isListed(std::string variable, std::vector<std::string>& names) {
+
+	for(uint32_t i = 0; i < names.size(); i++) {
+		if(names[i] == variable)
+			return true;
+	}
+
+	return false;
+}
+
+static bool isIndexedBy(AbstractExpressionNode* index, std::string variable) {
+	VariableNode* var = dynamic_cast<VariableNode*>(index);
+	return var != NULL && var->variable == variable;
+}
+
+///////////////////////////////////
+///////     Invariance      ///////
+///////////////////////////////////
+
+//true if the expression calls a function, writes to one of the names,
+//or assigns a whole array (which changes the length of every alias)
+static bool expressionInterferes(AbstractExpressionNode* node, std::vector<std::string>& names) {
+
+	if(dynamic_cast<FunctionExpressionNode*>(node) != NULL)
+		return true;
+
+	if(AssignmentExpressionNode* n = dynamic_cast<AssignmentExpressionNode*>(node)) {
+		if(isListed(n->variable, names) || n->evalType == ARRAY_T)
+			return true;
+	}
+
+	if(UnaryOperatorNode* n = dynamic_cast<UnaryOperatorNode*>(node)) {
+		ParseOperatorType op = n->operation;
+		VariableNode* var = dynamic_cast<VariableNode*>(n->leftArg);
+
+		if((op == POSTFIX_INC_OP || op == POSTFIX_DEC_OP || op == PREFIX_INC_OP || op == PREFIX_DEC_OP)
+				&& var != NULL && isListed(var->variable, names))
+			return true;
+	}
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+	for(uint32_t i = 0; i < children.size(); i++) {
+		if(expressionInterferes(*children[i], names))
+			return true;
+	}
+
+	return false;
+}
+
+//same as above for statements, which also can't declare another variable with one of the names
+static bool statementInterferes(AbstractStatementNode* node, std::vector<std::string>& names) {
+
+	if(NewAssignmentStatementNode* n = dynamic_cast<NewAssignmentStatementNode*>(node)) {
+		if(isListed(n->variable, names))
+			return true;
+	}
+
+	if(AssignmentStatementNode* n = dynamic_cast<AssignmentStatementNode*>(node)) {
+		if(isListed(n->variable, names) || n->value->evalType == ARRAY_T)
+			return true;
+	}
+
+	if(dynamic_cast<FunctionStatementNode*>(node) != NULL)
+		return true;
+
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++) {
+		if(expressionInterferes(*expressions[i], names))
+			return true;
+	}
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++) {
+		if(statementInterferes(statements[i], names))
+			return true;
+	}
+
+	return false;
+}
+
+///////////////////////////////////
+///////      Accesses       ///////
+///////////////////////////////////
+
+//element reads of a named array at exactly the loop variable
+static void collectAccesses(AbstractExpressionNode** location, std::string variable, std::vector<AbstractExpressionNode**>& accesses) {
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(*location);
+	for(uint32_t i = 0; i < children.size(); i++)
+		collectAccesses(children[i], variable, accesses);
+
+	ArrayAccessNode* node = dynamic_cast<ArrayAccessNode*>(*location);
+	if(node != NULL && !node->isSlice && node->array->evalType == ARRAY_T
+			&& dynamic_cast<VariableNode*>(node->array) != NULL && isIndexedBy(node->start, variable))
+		accesses.push_back(location);
+}
+
+//element reads, and element writes of arrays (string writes can change the length)
+static void collectAccesses(AbstractStatementNode* node, std::string variable, std::vector<AbstractExpressionNode**>& accesses,
+		std::vector<ArrayAssignmentStatementNode*>& assignments) {
+
+	ArrayAssignmentStatementNode* assignment = dynamic_cast<ArrayAssignmentStatementNode*>(node);
+	if(assignment != NULL && assignment->isArray && isIndexedBy(assignment->index, variable))
+		assignments.push_back(assignment);
+
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++)
+		collectAccesses(expressions[i], variable, accesses);
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		collectAccesses(statements[i], variable, accesses, assignments);
+}
+
+///////////////////////////////////
+///////     Range Check     ///////
+///////////////////////////////////
+
+//only loops like for(int i = 0; i < n; i++) where nothing in the loop changes i, n or the arrays,
+//so every index lies in [0, n) and one check of n against each length before the loop is enough
+static void eliminateInLoop(ForStatementNode* loop) {
+
+	NewAssignmentStatementNode* init = dynamic_cast<NewAssignmentStatementNode*>(loop->initialization);
+	if(init == NULL || init->type != INT32_T || init->value == NULL || intLiteralValue(init->value) < 0)
+		return;
+
+	std::string variable = init->variable;
+	if(loopStep(loop->update, variable) != 1)
+		return;
+
+	ComparisonOperatorNode* condition = dynamic_cast<ComparisonOperatorNode*>(loop->condition);
+	if(condition == NULL || condition->operation != LESS_OP || !isIndexedBy(condition->leftArg, variable))
+		return;
+
+	//limit has to be an int variable or literal
+	AbstractExpressionNode* limit = condition->rightArg;
+	VariableNode* limitVariable = dynamic_cast<VariableNode*>(limit);
+	if(limit->evalType != INT32_T || (limitVariable == NULL && intLiteralValue(limit) < 0))
+		return;
+
+	std::vector<AbstractExpressionNode**> accesses;
+	std::vector<ArrayAssignmentStatementNode*> assignments;
+	collectAccesses(loop->body, variable, accesses, assignments);
+
+	if(accesses.empty() && assignments.empty())
+		return;
+
+	std::vector<std::string> arrays;
+	for(uint32_t i = 0; i < accesses.size(); i++) {
+		std::string array = ((VariableNode*) ((ArrayAccessNode*) *accesses[i])->array)->variable;
+		if(!isListed(array, arrays))
+			arrays.push_back(array);
+	}
+
+	for(uint32_t i = 0; i < assignments.size(); i++) {
+		if(!isListed(assignments[i]->variable, arrays))
+			arrays.push_back(assignments[i]->variable);
+	}
+
+	std::vector<std::string> names = arrays;
+	names.push_back(variable);
+	if(limitVariable != NULL)
+		names.push_back(limitVariable->variable);
+
+	if(statementInterferes(loop->body, names))
+		return;
+
+	loop->guardedArrays = arrays;
+	loop->rangeLimit = limit;
+	loop->inRange = reserveSlots(1);
+
+	for(uint32_t i = 0; i < accesses.size(); i++)
+		*accesses[i] = new UncheckedArrayAccessNode((ArrayAccessNode*) *accesses[i], loop->inRange);
+
+	for(uint32_t i = 0; i < assignments.size(); i++)
+		assignments[i]->inRange = loop->inRange;
+}
+
+static void eliminateStatement(AbstractStatementNode* node) {
+
+	if(ForStatementNode* loop = dynamic_cast<ForStatementNode*>(node))
+		eliminateInLoop(loop);
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		eliminateStatement(statements[i]);
+}
+
+void eliminateBoundsChecks(std::vector<AbstractStatementNode*>* statements) {
+
+	for(uint32_t i = 0; i < statements->size(); i++)
+		eliminateStatement((*statements)[i]);
+}
@@ -0,0 +1,87 @@
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include "utils.h"
+#include "exceptions.h"
+#include "profile.h"
+#include "scratch.h"
+#include "builtineval.h"
+#include "budget.h"
+
+//units burned between two looks at the clock, reading it costs about as much as a few statements
+#define DEADLINE_CHECK_INTERVAL 4096
+
+//nothing is checked unless a limit is set
+thread_local uint64_t fuelCountdown = UINT64_MAX;
+
+static std::vector<char*>* budgetLines;
+static uint64_t fuelLimit = 0;
+static uint64_t fuelUsed = 0;
+static uint64_t granted = UINT64_MAX;
+static double timeout = 0;
+static uint64_t deadline = 0;
+static size_t heapLimit = 0;
+
+static void throwLimitExceeded(uint32_t line, const char* message) {
+
+	std::string context = "\t";
+	if(line > 0 && line <= budgetLines->size())
+		context.append(budgetLines->at(line-1));
+
+	throw LimitExceededException(copyString(message), copyString(context.c_str()), line);
+}
+
+//lets the program run until the fuel is gone or it's time to look at the clock again
+static void grantFuel() {
+
+	//one more than is left, so the last allowed unit doesn't throw
+	uint64_t left = (fuelLimit != 0) ? fuelLimit - fuelUsed + 1 : UINT64_MAX;
+	granted = (deadline != 0) ? std::min(left, (uint64_t) DEADLINE_CHECK_INTERVAL) : left;
+	fuelCountdown = granted;
+}
+
+void checkBudget(uint32_t line) {
+
+	char message[128];
+	fuelUsed += granted;
+
+	if(fuelLimit != 0 && fuelUsed > fuelLimit) {
+		snprintf(message, sizeof(message), "The program used up its fuel of %llu statements, loop iterations and calls",
+			(unsigned long long) fuelLimit);
+		throwLimitExceeded(line, message);
+	}
+
+	if(deadline != 0 && nanotime() >= deadline) {
+		snprintf(message, sizeof(message), "The program ran past its timeout of %g seconds", timeout);
+		throwLimitExceeded(line, message);
+	}
+
+	grantFuel();
+}
+
+void exceedHeapLimit(size_t size) {
+
+	char message[128];
+	snprintf(message, sizeof(message), "Allocating %llu more bytes would pass the heap limit of %llu bytes",
+		(unsigned long long) size, (unsigned long long) heapLimit);
+
+	//the frame's line is the statement that is allocating
+	throwLimitExceeded(profileTop->line, message);
+}
+
+void startBudget(std::vector<char*>* codeLines, uint64_t fuel, double timeoutSeconds, size_t maxHeapBytes) {
+
+	budgetLines = codeLines;
+	fuelLimit = fuel;
+	timeout = timeoutSeconds;
+	heapLimit = maxHeapBytes;
+
+	if(timeoutSeconds > 0)
+		deadline = nanotime() + (uint64_t) (timeoutSeconds * 1e9);
+	if(fuel != 0 || deadline != 0)
+		grantFuel();
+	if(maxHeapBytes != 0)
+		setHeapLimit(maxHeapBytes);
+}
@@ -0,0 +1,33 @@
+#include <cstdint>
+#include <ctime>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "builtineval.h"
+
+static uint64_t clockNanoseconds(clockid_t clock) {
+	struct timespec now;
+	clock_gettime(clock, &now);
+	return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+uint64_t nanotime() {
+	return clockNanoseconds(CLOCK_MONOTONIC);
+}
+
+uint64_t cputime() {
+	return clockNanoseconds(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+ParseData evaluateBuiltinFunctionExpression(BuiltinFunctionNode* node) {
+
+	ParseData d;
+	d.type = node->evalType;
+
+	switch(node->function) {
+		case NANOTIME_FUN: d.value.integer = nanotime(); break;
+		case CPUTIME_FUN: d.value.integer = cputime(); break;
+		default: d.value.integer = 0;
+	}
+
+	return d;
+}
@@ -0,0 +1,183 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "function.h"
+#include "callprofile.h"
+
+bool callProfiling = false;
+
+//times of every call to one function, in nanoseconds
+struct FunctionCalls {
+	Function* function;
+	uint64_t calls;
+	uint64_t inlinedCalls;
+	uint64_t inclusive;
+	uint64_t exclusive;
+	uint64_t arguments;
+
+	//calls of this function on the stack, only the outermost one adds inclusive time
+	uint32_t active;
+};
+
+//calls from one function to another, main is NULL
+struct CallEdge {
+	uint64_t calls;
+	uint64_t calleeExclusive;
+};
+
+struct CallFrame {
+	FunctionCalls* callee;
+	Function* caller;
+	uint64_t start;
+	uint64_t calleeTime;
+};
+
+static const char* reportFile;
+static std::map<Function*, FunctionCalls> functions;
+static std::map<std::pair<Function*, Function*>, CallEdge> edges;
+static std::vector<CallFrame> frames;
+
+uint64_t callProfileClock() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static Function* currentFunction() {
+	return frames.empty() ? NULL : frames.back().callee->function;
+}
+
+void enterProfiledCall(Function* function, uint64_t argumentsStart, bool inlined) {
+
+	uint64_t now = callProfileClock();
+
+	FunctionCalls& calls = functions[function];
+	calls.function = function;
+	calls.calls++;
+	calls.inlinedCalls += inlined;
+	calls.arguments += now - argumentsStart;
+	calls.active++;
+
+	CallFrame frame;
+	frame.callee = &calls;
+	frame.caller = currentFunction();
+	frame.start = now;
+	frame.calleeTime = 0;
+
+	edges[std::make_pair(frame.caller, function)].calls++;
+	frames.push_back(frame);
+}
+
+void countProfiledTailCall() {
+
+	CallFrame& frame = frames.back();
+	frame.callee->calls++;
+	edges[std::make_pair(frame.callee->function, frame.callee->function)].calls++;
+}
+
+void leaveProfiledCall() {
+
+	CallFrame frame = frames.back();
+	frames.pop_back();
+
+	uint64_t inclusive = callProfileClock() - frame.start;
+	uint64_t exclusive = inclusive - frame.calleeTime;
+
+	FunctionCalls& calls = *frame.callee;
+	calls.exclusive += exclusive;
+	if(--calls.active == 0)
+		calls.inclusive += inclusive;
+
+	edges[std::make_pair(frame.caller, calls.function)].calleeExclusive += exclusive;
+
+	//the caller's own time doesn't include this call (its arguments were evaluated by the caller, so they do)
+	if(!frames.empty())
+		frames.back().calleeTime += inclusive;
+}
+
+static const char* functionName(Function* function) {
+	return (function != NULL) ? function->name : "<main>";
+}
+
+static bool moreExclusive(const FunctionCalls& a, const FunctionCalls& b) {
+	if(a.exclusive != b.exclusive)
+		return a.exclusive > b.exclusive;
+	return strcmp(a.function->name, b.function->name) < 0;
+}
+
+static bool moreCalleeTime(const std::pair<std::pair<Function*, Function*>, CallEdge>& a,
+		const std::pair<std::pair<Function*, Function*>, CallEdge>& b) {
+	if(a.second.calleeExclusive != b.second.calleeExclusive)
+		return a.second.calleeExclusive > b.second.calleeExclusive;
+	return a.second.calls > b.second.calls;
+}
+
+static void writeReport(FILE* out) {
+
+	std::vector<FunctionCalls> sorted;
+	uint64_t totalCalls = 0;
+	uint64_t totalExclusive = 0;
+
+	for(std::map<Function*, FunctionCalls>::iterator it = functions.begin(); it != functions.end(); it++) {
+		sorted.push_back(it->second);
+		totalCalls += it->second.calls;
+		totalExclusive += it->second.exclusive;
+	}
+	std::sort(sorted.begin(), sorted.end(), moreExclusive);
+
+	fprintf(out, "call profile: %llu calls of %u functions\n", (unsigned long long) totalCalls, (uint32_t) sorted.size());
+	fprintf(out, "%-20s %12s %10s %12s %7s %12s %12s %12s\n", "function", "calls", "inlined", "excl ms", "excl %",
+		"incl ms", "args ms", "excl us/call");
+
+	for(uint32_t i = 0; i < sorted.size(); i++) {
+		FunctionCalls& calls = sorted[i];
+		fprintf(out, "%-20s %12llu %10llu %12.3f %7.1f %12.3f %12.3f %12.3f\n", calls.function->name,
+			(unsigned long long) calls.calls, (unsigned long long) calls.inlinedCalls, calls.exclusive / 1e6,
+			(totalExclusive != 0) ? 100.0 * calls.exclusive / totalExclusive : 0.0, calls.inclusive / 1e6,
+			calls.arguments / 1e6, calls.exclusive / 1e3 / calls.calls);
+	}
+
+	std::vector<std::pair<std::pair<Function*, Function*>, CallEdge> > graph(edges.begin(), edges.end());
+	std::sort(graph.begin(), graph.end(), moreCalleeTime);
+
+	fprintf(out, "\ncall graph:\n");
+	fprintf(out, "%-20s    %-20s %12s %16s\n", "caller", "callee", "calls", "callee excl ms");
+
+	for(uint32_t i = 0; i < graph.size(); i++) {
+		fprintf(out, "%-20s -> %-20s %12llu %16.3f\n", functionName(graph[i].first.first), functionName(graph[i].first.second),
+			(unsigned long long) graph[i].second.calls, graph[i].second.calleeExclusive / 1e6);
+	}
+}
+
+static void finishCallProfile() {
+
+	//a runtime error leaves calls open, they end here
+	while(!frames.empty())
+		leaveProfiledCall();
+	callProfiling = false;
+
+	if(reportFile == NULL) {
+		writeReport(stderr);
+		return;
+	}
+
+	FILE* out = fopen(reportFile, "w");
+	if(out == NULL) {
+		fprintf(stderr, "Couldn't write the call profile to %s: %s\n", reportFile, strerror(errno));
+		return;
+	}
+
+	writeReport(out);
+	fclose(out);
+}
+
+void startCallProfiling(const char* file) {
+	reportFile = file;
+	callProfiling = true;
+	atexit(finishCallProfile);
+}
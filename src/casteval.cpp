@@ -4,11 +4,14 @@
 #include <string>
 #include <iostream>
 #include "utils.h"
+#include "numconv.h"
 #include "token.h"
 #include "typehandler.h"
 #include "parsetoken.h"
 #include "parsenode.h"
 #include "casteval.h"
+#include "scratch.h"
+#include "counters.h"
 
 using namespace std;
 
@@ -16,8 +19,10 @@ using namespace std;
 ParseData castHelper(ParseData orig, ParseDataType finalType) {
   
   ParseDataType origType = orig.type;
+  COUNT_CAST(origType, finalType);
   ParseData d;
   d.type = finalType;
+  char text[MAX_NUMBER_LENGTH + 1];
   
   switch(origType) {
         
@@ -54,7 +59,7 @@ ParseData castHelper(ParseData orig, ParseDataType finalType) {
         case UINT64_T: d.value.integer = (uint64_t) ((unsigned char) orig.value.integer); break;
         case DOUBLE_T: d.value.floatingPoint = (double) ((unsigned char) orig.value.integer); break;
         case STRING_T: {
-          char* res = new char[2];
+          char* res = (char*) allocateHeap(2);
           res[0] = (unsigned char) orig.value.integer;
           res[1] = '\0';
           d.value.allocated = (void*) res;
@@ -74,7 +79,7 @@ ParseData castHelper(ParseData orig, ParseDataType finalType) {
         case UINT64_T: d.value.integer = (uint64_t) ((int32_t) orig.value.integer); break;
         case DOUBLE_T: d.value.floatingPoint = (double) ((int32_t) orig.value.integer); break;
         case STRING_T: {
-          d.value.allocated = (void*) copyString(std::to_string((int32_t) orig.value.integer).c_str());
+          d.value.allocated = (void*) copyNumber(text, formatSigned((int32_t) orig.value.integer, text));
           break;
         }
       }
@@ -91,7 +96,7 @@ ParseData castHelper(ParseData orig, ParseDataType finalType) {
         case UINT64_T: d.value.integer = (uint64_t) ((int64_t) orig.value.integer); break;
         case DOUBLE_T: d.value.floatingPoint = (double) ((int64_t) orig.value.integer); break;
         case STRING_T: {
-          d.value.allocated = (void*) copyString(std::to_string((int64_t) orig.value.integer).c_str());
+          d.value.allocated = (void*) copyNumber(text, formatSigned((int64_t) orig.value.integer, text));
           break;
         }
       }
@@ -108,7 +113,7 @@ ParseData castHelper(ParseData orig, ParseDataType finalType) {
         case UINT64_T: d.value.integer = (uint64_t) ((uint32_t) orig.value.integer); break;
         case DOUBLE_T: d.value.floatingPoint = (double) ((uint32_t) orig.value.integer); break;
         case STRING_T: {
-          d.value.allocated = (void*) copyString(std::to_string((uint32_t) orig.value.integer).c_str());
+          d.value.allocated = (void*) copyNumber(text, formatUnsigned((uint32_t) orig.value.integer, text));
           break;
         }
       }
@@ -125,7 +130,7 @@ ParseData castHelper(ParseData orig, ParseDataType finalType) {
         case UINT64_T: d.value.integer = (uint64_t) ((uint64_t) orig.value.integer); break;
         case DOUBLE_T: d.value.floatingPoint = (double) ((uint64_t) orig.value.integer); break;
         case STRING_T: {
-          d.value.allocated = (void*) copyString(std::to_string((uint64_t) orig.value.integer).c_str());
+          d.value.allocated = (void*) copyNumber(text, formatUnsigned((uint64_t) orig.value.integer, text));
           break;
         }
       }
@@ -143,7 +148,7 @@ ParseData castHelper(ParseData orig, ParseDataType finalType) {
         case UINT64_T: d.value.integer = (uint64_t) ((double) orig.value.floatingPoint); break; 
         case DOUBLE_T: d.value.floatingPoint = orig.value.floatingPoint; break;
         case STRING_T: {
-          d.value.allocated = (void*) copyString(std::to_string((double) orig.value.floatingPoint).c_str());
+          d.value.allocated = (void*) copyNumber(text, formatDouble((double) orig.value.floatingPoint, text));
           break;
         }
       }
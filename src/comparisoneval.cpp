@@ -6,6 +6,7 @@
 #include "typehandler.h"
 #include "parsetoken.h"
 #include "parsenode.h"
+#include "counters.h"
 
 
 //generic helper methods (to keep source code concise)
@@ -91,7 +92,7 @@ ParseData evaluateComparisonExpression(ComparisonOperatorNode* node) {
   //recursively evaluate left and right subtrees
   ParseData left = node->leftArg->evaluate();
   ParseData right = node->rightArg->evaluate();
-  
+  COUNT_OPERATION(node->operation, left.type, right.type);
   
   switch(node->operation) {
     
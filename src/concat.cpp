@@ -0,0 +1,66 @@
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "statementnode.h"
+#include "optimizer.h"
+#include "arithmeticeval.h"
+#include "concat.h"
+#include "program.h"
+
+//operands of the chain from left to right, which is also the order they are evaluated in
+static void collectOperands(AbstractExpressionNode* node, std::vector<AbstractExpressionNode*>& operands) {
+
+	if(!isStringConcatenation(node)) {
+		operands.push_back(node);
+		return;
+	}
+
+	if(GroupedExpressionNode* n = dynamic_cast<GroupedExpressionNode*>(node)) {
+		collectOperands(n->closedExpression, operands);
+		return;
+	}
+
+	ArithmeticOperatorNode* n = (ArithmeticOperatorNode*) node;
+	collectOperands(n->leftArg, operands);
+	collectOperands(n->rightArg, operands);
+}
+
+static void fuseExpression(AbstractExpressionNode** location) {
+
+	//outermost + of a chain (a chain in parentheses is reached through its group)
+	if(isStringConcatenation(*location) && dynamic_cast<GroupedExpressionNode*>(*location) == NULL) {
+
+		std::vector<AbstractExpressionNode*> found;
+		collectOperands(*location, found);
+
+		uint32_t numOperands = found.size();
+		AbstractExpressionNode** operands = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * numOperands);
+		for(uint32_t i = 0; i < numOperands; i++)
+			operands[i] = found[i];
+
+		*location = new ConcatenationNode(*location, operands, numOperands);
+	}
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(*location);
+	for(uint32_t i = 0; i < children.size(); i++)
+		fuseExpression(children[i]);
+}
+
+static void fuseStatement(AbstractStatementNode* node) {
+
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++)
+		fuseExpression(expressions[i]);
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		fuseStatement(statements[i]);
+}
+
+void fuseConcatenations(std::vector<AbstractStatementNode*>* statements) {
+
+	for(uint32_t i = 0; i < statements->size(); i++)
+		fuseStatement((*statements)[i]);
+}
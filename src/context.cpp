@@ -0,0 +1,37 @@
+#include <cstdint>
+#include <cstdlib>
+#include "parsetoken.h"
+#include "symboltable.h"
+#include "program.h"
+#include "profile.h"
+#include "context.h"
+
+thread_local ExecutionContext* runningContext = NULL;
+
+uint32_t reserveSlots(uint32_t count) {
+	uint32_t first = compilingProgram->numSlots;
+	compilingProgram->numSlots += count;
+	return first;
+}
+
+ExecutionContext::ExecutionContext(uint32_t numSlots) {
+	frame = NULL;
+	slots = (ParseData*) calloc(numSlots + 1, sizeof(ParseData));
+
+	//the first run on this thread starts the shadow stack at main
+	if(profileTop == NULL) {
+		profileTop = profileStack;
+		profileDepth = 0;
+	}
+	previousProfileTop = profileTop;
+	previousProfileDepth = profileDepth;
+}
+
+ExecutionContext::~ExecutionContext() {
+	profileTop = previousProfileTop;
+	profileDepth = previousProfileDepth;
+
+	free(slots);
+	for(uint32_t i = 0; i < heap.size(); i++)
+		free(heap[i]);
+}
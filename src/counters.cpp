@@ -0,0 +1,159 @@
+#ifdef COUNTERS
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "parsetoken.h"
+#include "counters.h"
+
+#define NUM_OPERATIONS (INVALID_OP + 1)
+#define NUM_TYPES (INVALID_T + 1)
+
+//deeper lookups are counted with the last one
+#define MAX_COUNTED_SCOPES 16
+
+//width of the longest bar in a histogram
+#define BAR_WIDTH 40
+
+bool counting = false;
+
+//node counters are owned here so they outlive every static pointer to them
+static std::vector<std::pair<const char*, uint64_t*> > nodes;
+static uint64_t operations[NUM_OPERATIONS][NUM_TYPES][NUM_TYPES];
+static uint64_t casts[NUM_TYPES][NUM_TYPES];
+static uint64_t lookups[MAX_COUNTED_SCOPES + 1];
+static uint64_t missedLookups = 0;
+
+typedef std::vector<std::pair<std::string, uint64_t> > Histogram;
+
+uint64_t* registerCounter(const char* name) {
+	uint64_t* counter = new uint64_t(0);
+	nodes.push_back(std::make_pair(name, counter));
+	return counter;
+}
+
+void countOperation(ParseOperatorType operation, ParseDataType left, ParseDataType right) {
+	operations[operation][left][right]++;
+}
+
+void countCast(ParseDataType from, ParseDataType to) {
+	casts[from][to]++;
+}
+
+void countLookup(uint32_t scopesSearched, bool found) {
+	if(found)
+		lookups[std::min(scopesSearched, (uint32_t) MAX_COUNTED_SCOPES)]++;
+	else
+		missedLookups++;
+}
+
+static std::string operatorName(ParseOperatorType operation) {
+	switch(operation) {
+		case PREFIX_INC_OP: return "prefix ++";
+		case PREFIX_DEC_OP: return "prefix --";
+		case POSTFIX_INC_OP: return "postfix ++";
+		case POSTFIX_DEC_OP: return "postfix --";
+		default: return toStringParseOperatorType(operation);
+	}
+}
+
+static bool moreCounts(const std::pair<std::string, uint64_t>& a, const std::pair<std::string, uint64_t>& b) {
+	if(a.second != b.second)
+		return a.second > b.second;
+	return a.first < b.first;
+}
+
+//one row per key, largest first, with its share of the section and a bar scaled to the largest
+static void printHistogram(const char* title, Histogram& rows, bool sorted) {
+
+	uint64_t total = 0;
+	uint64_t largest = 0;
+	for(uint32_t i = 0; i < rows.size(); i++) {
+		total += rows[i].second;
+		largest = std::max(largest, rows[i].second);
+	}
+
+	fprintf(stderr, "%s (%llu):\n", title, (unsigned long long) total);
+	if(sorted)
+		std::sort(rows.begin(), rows.end(), moreCounts);
+
+	for(uint32_t i = 0; i < rows.size(); i++) {
+		std::string bar(largest ? (size_t) (BAR_WIDTH * rows[i].second / largest) : 0, '#');
+		fprintf(stderr, "  %-32s %14llu %6.2f%%  %s\n", rows[i].first.c_str(), (unsigned long long) rows[i].second,
+			100.0 * rows[i].second / total, bar.c_str());
+	}
+	fprintf(stderr, "\n");
+}
+
+static void printCounters() {
+
+	counting = false;
+
+	//the same node class can be counted at several places
+	Histogram nodeRows;
+	for(uint32_t i = 0; i < nodes.size(); i++) {
+		Histogram::iterator it = nodeRows.begin();
+		while(it != nodeRows.end() && it->first != nodes[i].first)
+			it++;
+
+		if(it != nodeRows.end())
+			it->second += *nodes[i].second;
+		else if(*nodes[i].second != 0)
+			nodeRows.push_back(std::make_pair(std::string(nodes[i].first), *nodes[i].second));
+	}
+	printHistogram("nodes evaluated and executed", nodeRows, true);
+
+	//unary operators have no right operand and are counted with INVALID_T there
+	Histogram operationRows;
+	for(uint32_t op = 0; op < NUM_OPERATIONS; op++) {
+		for(uint32_t left = 0; left < NUM_TYPES; left++) {
+			for(uint32_t right = 0; right < NUM_TYPES; right++) {
+				uint64_t count = operations[op][left][right];
+				if(count == 0)
+					continue;
+
+				std::string name = operatorName((ParseOperatorType) op) + " " + toStringParseDataType((ParseDataType) left);
+				if(right != INVALID_T)
+					name = std::string(toStringParseDataType((ParseDataType) left)) + " " + operatorName((ParseOperatorType) op)
+						+ " " + toStringParseDataType((ParseDataType) right);
+				operationRows.push_back(std::make_pair(name, count));
+			}
+		}
+	}
+	printHistogram("operations by operand types", operationRows, true);
+
+	Histogram castRows;
+	for(uint32_t from = 0; from < NUM_TYPES; from++) {
+		for(uint32_t to = 0; to < NUM_TYPES; to++) {
+			if(casts[from][to] != 0) {
+				castRows.push_back(std::make_pair(std::string(toStringParseDataType((ParseDataType) from)) + " -> "
+					+ toStringParseDataType((ParseDataType) to), casts[from][to]));
+			}
+		}
+	}
+	printHistogram("casts", castRows, true);
+
+	Histogram lookupRows;
+	for(uint32_t i = 0; i <= MAX_COUNTED_SCOPES; i++) {
+		if(lookups[i] == 0)
+			continue;
+
+		char name[32];
+		snprintf(name, sizeof(name), (i < MAX_COUNTED_SCOPES) ? "%u scopes out" : "%u or more scopes out", i);
+		lookupRows.push_back(std::make_pair(std::string(name), lookups[i]));
+	}
+	if(missedLookups != 0)
+		lookupRows.push_back(std::make_pair(std::string("not found"), missedLookups));
+	printHistogram("variable lookups by scope", lookupRows, false);
+}
+
+void startCounting() {
+	counting = true;
+	atexit(printCounters);
+}
+
+#endif
@@ -0,0 +1,327 @@
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <unordered_map>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "statementnode.h"
+#include "function.h"
+#include "optimizer.h"
+#include "cse.h"
+#include "context.h"
+
+//an expression value that is available for reuse
+struct AvailableExpression {
+	AbstractExpressionNode** location;
+	CommonSubexpressionNode* producer; //NULL until a second occurrence shows up
+	std::vector<std::string> variables; //variables the value depends on
+	bool readsArrays;
+	bool readsStrings;
+};
+
+//values computed so far in the current straight-line region, by structural key
+static thread_local std::unordered_map<std::string, AvailableExpression> available;
+
+//name under which a variable or inlined parameter is tracked
+static std::string variableKey(AbstractExpressionNode* node) {
+
+	if(VariableNode* n = dynamic_cast<VariableNode*>(node))
+		return n->variable;
+
+	//parameters of inlined calls can't clash with real variable names
+	if(ParameterNode* n = dynamic_cast<ParameterNode*>(node)) {
+		char buffer[32];
+		sprintf(buffer, "@%u", n->parameter);
+		return std::string(buffer);
+	}
+
+	return "";
+}
+
+//structural key of a side-effect free expression, or "" if it has side effects
+static std::string expressionKey(AbstractExpressionNode* node) {
+
+	std::string key;
+
+	if(GroupedExpressionNode* n = dynamic_cast<GroupedExpressionNode*>(node))
+		return expressionKey(n->closedExpression);
+
+	if(VariableNode* n = dynamic_cast<VariableNode*>(node)) {
+		key = "v:";
+		key.append(n->variable);
+		return key;
+	}
+
+	if(dynamic_cast<ParameterNode*>(node) != NULL) {
+		key = "v:";
+		key.append(variableKey(node));
+		return key;
+	}
+
+	if(LiteralNode* n = dynamic_cast<LiteralNode*>(node)) {
+		ParseData d = n->data;
+
+		//strings and arrays would be compared by address, so leave them alone
+		if(d.type == STRING_T || d.type == ARRAY_T)
+			return "";
+
+		char buffer[64];
+		sprintf(buffer, "l:%d:%llx", (int) d.type, (unsigned long long) d.value.integer);
+		return std::string(buffer);
+	}
+
+	char header[32];
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+
+	if(AbstractBinaryOperatorNode* n = dynamic_cast<AbstractBinaryOperatorNode*>(node)) {
+		sprintf(header, "b%d", (int) n->operation);
+
+	} else if(UnaryOperatorNode* n = dynamic_cast<UnaryOperatorNode*>(node)) {
+		ParseOperatorType op = n->operation;
+		if(op == POSTFIX_INC_OP || op == POSTFIX_DEC_OP || op == PREFIX_INC_OP || op == PREFIX_DEC_OP)
+			return "";
+		sprintf(header, "u%d", (int) op);
+
+	} else if(CastNode* n = dynamic_cast<CastNode*>(node)) {
+		sprintf(header, "c%d", (int) n->finalType);
+
+	} else if(ArrayAccessNode* n = dynamic_cast<ArrayAccessNode*>(node)) {
+		sprintf(header, "a%d", (int) n->isSlice);
+
+	} else {
+		//assignments, calls, array literals and previously shared values
+		return "";
+	}
+
+	key = header;
+	key.append("(");
+	for(uint32_t i = 0; i < children.size(); i++) {
+		std::string childKey = expressionKey(*children[i]);
+		if(childKey.empty())
+			return "";
+		key.append(childKey);
+		key.append(",");
+	}
+	key.append(")");
+
+	return key;
+}
+
+//collect what a pure expression reads, so writes can invalidate it
+static void collectReads(AbstractExpressionNode* node, AvailableExpression& entry) {
+
+	if(dynamic_cast<VariableNode*>(node) != NULL || dynamic_cast<ParameterNode*>(node) != NULL)
+		entry.variables.push_back(variableKey(node));
+
+	if(node->evalType == ARRAY_T)
+		entry.readsArrays = true;
+	if(node->evalType == STRING_T)
+		entry.readsStrings = true;
+
+	//a reader depends on everything the shared expression reads
+	if(CommonSubexpressionNode* n = dynamic_cast<CommonSubexpressionNode*>(node)) {
+		collectReads(n->expression, entry);
+		return;
+	}
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+	for(uint32_t i = 0; i < children.size(); i++)
+		collectReads(*children[i], entry);
+}
+
+///////////////////////////////////
+///////       Kills         ///////
+///////////////////////////////////
+
+static void killVariable(std::string variable) {
+
+	std::unordered_map<std::string, AvailableExpression>::iterator it = available.begin();
+	while(it != available.end()) {
+
+		bool killed = false;
+		for(uint32_t i = 0; i < it->second.variables.size(); i++) {
+			if(it->second.variables[i] == variable)
+				killed = true;
+		}
+
+		if(killed)
+			it = available.erase(it);
+		else
+			it++;
+	}
+}
+
+//arrays alias on assignment and strings alias through parameters, so a write
+//to any element invalidates every value that looks inside an array (or string)
+static void killElements(bool arrays) {
+
+	std::unordered_map<std::string, AvailableExpression>::iterator it = available.begin();
+	while(it != available.end()) {
+		if((arrays && it->second.readsArrays) || (!arrays && it->second.readsStrings))
+			it = available.erase(it);
+		else
+			it++;
+	}
+}
+
+///////////////////////////////////
+///////      Traversal      ///////
+///////////////////////////////////
+
+//only scalar values are shared, strings and arrays are mutable and get copied around
+static bool isCandidate(AbstractExpressionNode* node) {
+
+	if(node->evalType == STRING_T || node->evalType == ARRAY_T)
+		return false;
+
+	return dynamic_cast<VariableNode*>(node) == NULL && dynamic_cast<ParameterNode*>(node) == NULL
+			&& dynamic_cast<LiteralNode*>(node) == NULL && dynamic_cast<GroupedExpressionNode*>(node) == NULL;
+}
+
+//walk the expression in evaluation order, reusing values that are still valid
+//and recording the effects of assignments and calls
+static void visitExpression(AbstractExpressionNode** location) {
+
+	AbstractExpressionNode* node = *location;
+	std::string key = isCandidate(node) ? expressionKey(node) : "";
+
+	//same value was computed earlier and nothing it reads has changed since
+	if(!key.empty() && available.find(key) != available.end()) {
+
+		AvailableExpression& entry = available[key];
+		if(entry.producer == NULL) {
+			entry.producer = new CommonSubexpressionNode(*entry.location, reserveSlots(1), true);
+			*entry.location = entry.producer;
+		}
+
+		*location = new CommonSubexpressionNode(node, entry.producer->value, false);
+		return;
+	}
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+	for(uint32_t i = 0; i < children.size(); i++) {
+
+		//parameters of an inlined call are rebound between its arguments and its body
+		InlinedFunctionNode* call = dynamic_cast<InlinedFunctionNode*>(node);
+		if(call != NULL && children[i] == &call->body) {
+			for(uint32_t j = 0; j < call->numArgs; j++) {
+				char buffer[32];
+				sprintf(buffer, "@%u", call->parameters + j);
+				killVariable(std::string(buffer));
+			}
+		}
+
+		visitExpression(children[i]);
+	}
+
+	//effects take place after the operands are evaluated
+	if(AssignmentExpressionNode* n = dynamic_cast<AssignmentExpressionNode*>(node)) {
+		killVariable(n->variable);
+		if(n->evalType == ARRAY_T)
+			killElements(true);
+
+	} else if(ArrayAssignmentExpressionNode* n = dynamic_cast<ArrayAssignmentExpressionNode*>(node)) {
+		killElements(n->array->evalType == ARRAY_T);
+
+	} else if(UnaryOperatorNode* n = dynamic_cast<UnaryOperatorNode*>(node)) {
+		ParseOperatorType op = n->operation;
+		if(op == POSTFIX_INC_OP || op == POSTFIX_DEC_OP || op == PREFIX_INC_OP || op == PREFIX_DEC_OP)
+			killVariable(variableKey(n->leftArg));
+
+	} else if(dynamic_cast<FunctionExpressionNode*>(node) != NULL) {
+		//function bodies see (and can change) the caller's variables
+		available.clear();
+	}
+
+	if(!key.empty()) {
+		AvailableExpression entry;
+		entry.location = location;
+		entry.producer = NULL;
+		entry.readsArrays = false;
+		entry.readsStrings = false;
+		collectReads(node, entry);
+		available[key] = entry;
+	}
+}
+
+static void visitStatements(std::vector<AbstractStatementNode*>* statements);
+
+//nested statements start their own regions
+static void visitNested(AbstractStatementNode* node) {
+
+	if(GroupedStatementNode* n = dynamic_cast<GroupedStatementNode*>(node)) {
+		visitStatements(n->statements);
+		return;
+	}
+
+	if(FunctionStatementNode* n = dynamic_cast<FunctionStatementNode*>(node)) {
+		if(n->function != NULL)
+			visitStatements(n->function->body);
+		return;
+	}
+
+	//every condition is its own region, the branches don't run in a fixed order
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++) {
+		available.clear();
+		visitExpression(expressions[i]);
+	}
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++) {
+		available.clear();
+		visitNested(statements[i]);
+	}
+}
+
+//a region is a run of statements in one block that execute in order without branching
+static void visitStatements(std::vector<AbstractStatementNode*>* statements) {
+
+	available.clear();
+
+	for(uint32_t i = 0; i < statements->size(); i++) {
+
+		AbstractStatementNode* node = (*statements)[i];
+
+		if(NewAssignmentStatementNode* n = dynamic_cast<NewAssignmentStatementNode*>(node)) {
+			if(n->value != NULL)
+				visitExpression(&n->value);
+			killVariable(n->variable);
+
+		} else if(AssignmentStatementNode* n = dynamic_cast<AssignmentStatementNode*>(node)) {
+			visitExpression(&n->value);
+			killVariable(n->variable);
+
+			//array assignment copies into the existing array
+			if(n->value->evalType == ARRAY_T)
+				killElements(true);
+
+		} else if(ArrayAssignmentStatementNode* n = dynamic_cast<ArrayAssignmentStatementNode*>(node)) {
+			visitExpression(&n->index);
+			visitExpression(&n->value);
+			killElements(n->isArray);
+
+		} else if(dynamic_cast<ExpressionStatementNode*>(node) != NULL || dynamic_cast<PrintStatementNode*>(node) != NULL
+				|| dynamic_cast<PrintLineStatementNode*>(node) != NULL || dynamic_cast<ReturnStatementNode*>(node) != NULL) {
+			visitExpression(childExpressions(node)[0]);
+
+		} else if(dynamic_cast<PrintFormattedStatementNode*>(node) != NULL) {
+			std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+			for(uint32_t j = 0; j < expressions.size(); j++)
+				visitExpression(expressions[j]);
+
+		} else {
+			//control flow ends the region
+			visitNested(node);
+			available.clear();
+		}
+	}
+
+	available.clear();
+}
+
+void eliminateCommonSubexpressions(std::vector<AbstractStatementNode*>* statements) {
+	visitStatements(statements);
+}
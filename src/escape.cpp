@@ -0,0 +1,129 @@
+#include <vector>
+#include <cstdint>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "statementnode.h"
+#include "function.h"
+#include "optimizer.h"
+#include "escape.h"
+
+static bool isReference(AbstractExpressionNode* node) {
+	return node->evalType == STRING_T || node->evalType == ARRAY_T;
+}
+
+//escapes is true if the value can still be reachable once the current statement is done,
+//e.g. it is stored in a variable, an array, a parameter or returned
+static void visitExpression(AbstractExpressionNode* node, bool escapes) {
+
+	if(GroupedExpressionNode* n = dynamic_cast<GroupedExpressionNode*>(node)) {
+		visitExpression(n->closedExpression, escapes);
+		return;
+	}
+
+	if(ArithmeticOperatorNode* n = dynamic_cast<ArithmeticOperatorNode*>(node)) {
+		n->isTemporary = !escapes && isReference(n);
+
+		//string results are fresh copies, but array results share the elements of their operands
+		bool operandsEscape = escapes && n->evalType == ARRAY_T;
+		visitExpression(n->leftArg, operandsEscape);
+		visitExpression(n->rightArg, operandsEscape);
+		return;
+	}
+
+	//every operand is copied into the result
+	if(ConcatenationNode* n = dynamic_cast<ConcatenationNode*>(node)) {
+		n->isTemporary = !escapes;
+		for(uint32_t i = 0; i < n->numOperands; i++)
+			visitExpression(n->operands[i], false);
+		return;
+	}
+
+	if(ArrayAccessNode* n = dynamic_cast<ArrayAccessNode*>(node)) {
+		n->isTemporary = !escapes && n->isSlice;
+
+		//substrings and chars are copies, array elements and subarrays are not
+		visitExpression(n->array, escapes && n->array->evalType == ARRAY_T);
+		visitExpression(n->start, false);
+		if(n->isSlice)
+			visitExpression(n->end, false);
+		return;
+	}
+
+	if(UncheckedArrayAccessNode* n = dynamic_cast<UncheckedArrayAccessNode*>(node)) {
+		visitExpression(n->access->array, escapes);
+		visitExpression(n->access->start, false);
+		return;
+	}
+
+	//these only read their operands (a cast to string makes its own copy)
+	if(dynamic_cast<ComparisonOperatorNode*>(node) != NULL || dynamic_cast<BitLogicalOperatorNode*>(node) != NULL
+			|| dynamic_cast<CastNode*>(node) != NULL || dynamic_cast<IntegerPowerNode*>(node) != NULL
+			|| dynamic_cast<ConstantDivisionNode*>(node) != NULL) {
+
+		std::vector<AbstractExpressionNode**> children = childExpressions(node);
+		for(uint32_t i = 0; i < children.size(); i++)
+			visitExpression(*children[i], escapes && (*children[i])->evalType == ARRAY_T);
+		return;
+	}
+
+	//inlined body produces the call's result
+	if(InlinedFunctionNode* n = dynamic_cast<InlinedFunctionNode*>(node)) {
+		for(uint32_t i = 0; i < n->numArgs; i++)
+			visitExpression(n->arguments[i], true);
+		visitExpression(n->body, escapes);
+		return;
+	}
+
+	//natives only read their arguments while they run, and return strings of their own
+	if(NativeFunctionNode* n = dynamic_cast<NativeFunctionNode*>(node)) {
+		n->isTemporary = !escapes && isReference(n);
+		for(uint32_t i = 0; i < n->numArgs; i++)
+			visitExpression(n->arguments[i], false);
+		return;
+	}
+
+	//assignments, calls, array literals and everything else keep their operands around
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+	for(uint32_t i = 0; i < children.size(); i++)
+		visitExpression(*children[i], true);
+}
+
+static void visitStatement(AbstractStatementNode* node) {
+
+	//printed and discarded values, and strings that are copied when they are stored
+	bool dropped = false;
+
+	if(dynamic_cast<ExpressionStatementNode*>(node) != NULL || dynamic_cast<PrintStatementNode*>(node) != NULL
+			|| dynamic_cast<PrintLineStatementNode*>(node) != NULL || dynamic_cast<PrintFormattedStatementNode*>(node) != NULL
+			|| dynamic_cast<ConditionalStatementNode*>(node) != NULL
+			|| dynamic_cast<WhileStatementNode*>(node) != NULL || dynamic_cast<ForStatementNode*>(node) != NULL
+			|| dynamic_cast<BenchStatementNode*>(node) != NULL) {
+		dropped = true;
+
+	} else if(NewAssignmentStatementNode* n = dynamic_cast<NewAssignmentStatementNode*>(node)) {
+		dropped = n->type != ARRAY_T;
+
+	} else if(AssignmentStatementNode* n = dynamic_cast<AssignmentStatementNode*>(node)) {
+		dropped = n->value->evalType != ARRAY_T;
+
+	} else if(ArrayAssignmentStatementNode* n = dynamic_cast<ArrayAssignmentStatementNode*>(node)) {
+		visitExpression(n->index, false);
+		visitExpression(n->value, true);
+	}
+
+	if(dynamic_cast<ArrayAssignmentStatementNode*>(node) == NULL) {
+		std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+		for(uint32_t i = 0; i < expressions.size(); i++)
+			visitExpression(*expressions[i], !dropped);
+	}
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		visitStatement(statements[i]);
+}
+
+void markTemporaries(std::vector<AbstractStatementNode*>* statements) {
+
+	for(uint32_t i = 0; i < statements->size(); i++)
+		visitStatement((*statements)[i]);
+}
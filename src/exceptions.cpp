@@ -32,4 +32,42 @@ const char* OutOfBoundsException::what() const throw() {
 	str.append(std::to_string(length));
 
 	return copyString(str.c_str());
-}
\ No newline at end of file
+}
+
+const char* LimitExceededException::what() const throw() {
+
+	std::string str = "LimitExceededException on line ";
+	str.append(std::to_string(line));
+	str.append(":\n");
+	str.append(context);
+	str.append(message);
+
+	return copyString(str.c_str());
+}
+
+NativeException::NativeException(const char* mes)
+	: message{copyString(mes)}, context{NULL}, startLine{0}, endLine{0} {}
+
+const char* NativeException::what() const throw() {
+
+	if(context == NULL)
+		return message;
+
+	std::string str = "";
+
+	if(startLine == endLine) {
+		str.append("NativeException on line ");
+		str.append(std::to_string(startLine));
+	} else {
+		str.append("NativeException from line ");
+		str.append(std::to_string(startLine));
+		str.append(" to ");
+		str.append(std::to_string(endLine));
+	}
+
+	str.append(":\n\t");
+	str.append(context);
+	str.append(message);
+
+	return copyString(str.c_str());
+}
@@ -11,35 +11,56 @@
 #include "executor.h"
 #include "casteval.h"
 #include "array.h"
+#include "function.h"
 #include "exceptions.h"
+#include "scratch.h"
+#include "output.h"
+#include "format.h"
+#include "context.h"
 
 void executeExpressionStatement(ExpressionStatementNode* node) {
   node->expression->evaluate();
 }
 
 void executePrintStatement(PrintStatementNode* node) {
-  std::cout << toStringParseData(node->expression->evaluate());
+  printValue(node->expression->evaluate(), false);
 }
 
 void executePrintLineStatement(PrintLineStatementNode* node) {
-  std::cout << toStringParseData(node->expression->evaluate()) << std::endl;  
+  printValue(node->expression->evaluate(), true);
+}
+
+void executePrintFormattedStatement(PrintFormattedStatementNode* node) {
+
+  uint32_t numArgs = node->numArgs;
+  ParseData values[numArgs];
+
+  for(uint32_t i = 0; i < numArgs; i++)
+    values[i] = node->arguments[i]->evaluate();
+
+  printFormatted(*node->specifiers, values);
+  endPrint();
 }
 
 void executeGroupedStatement(GroupedStatementNode* node) {
   
   //symbol table enters new scope
-  node->symbolTable->enterNewScope();
+  runningContext->variables.enterNewScope();
   
   //sequentially execute statements
   std::vector<AbstractStatementNode*>* statements = node->statements;
   std::vector<AbstractStatementNode*>::iterator it;
+
+  //temporaries of a statement are gone once it's done
+  ScratchMark mark = scratchMark();
   
   for(it = statements->begin(); it != statements->end(); it++) {
     (*it)->execute();
+    scratchRelease(mark);
   }
 	
 	//leave the block scope
-	node->symbolTable->leaveScope();
+	runningContext->variables.leaveScope();
 }
 
 void executeConditionalStatement(ConditionalStatementNode* node) {
@@ -51,10 +72,12 @@ void executeConditionalStatement(ConditionalStatementNode* node) {
   
   it1 = conditions->begin();
   it2 = statements->begin();
+  ScratchMark mark = scratchMark();
   
   for(; it1 != conditions->end(); it1++, it2++) {
     
     ParseData d = (*it1)->evaluate();
+    scratchRelease(mark);
     if(d.type == BOOL_T && d.value.integer != 0) {
       
       (*it2)->execute();
@@ -67,7 +90,7 @@ void executeConditionalStatement(ConditionalStatementNode* node) {
 void executeNewAssignmentStatement(NewAssignmentStatementNode* node) {
   
   //get stuff out of the node first
-  SymbolTable* symbolTable = node->symbolTable;
+  SymbolTable* symbolTable = &runningContext->variables;
   std::string variable = node->variable;
   ParseDataType type = node->type;
 	ParseDataType subType = node->subType;
@@ -80,8 +103,10 @@ void executeNewAssignmentStatement(NewAssignmentStatementNode* node) {
 		if(type == ARRAY_T) {
 
 			//if array, change array value's subtype to fit variable's subtype
+			//(only arrays this run created can differ, so values shared between runs are never written)
 			Array* arr = (Array*) d.value.allocated;
-			arr->subtype = subType;
+			if(arr->subtype != subType)
+				arr->subtype = subType;
 			symbolTable->declare(variable, d);
 
 		} else {
@@ -100,7 +125,7 @@ void executeNewAssignmentStatement(NewAssignmentStatementNode* node) {
 void executeAssignmentStatement(AssignmentStatementNode* node) {
 	
   //get stuff out of the node first
-  SymbolTable* symbolTable = node->symbolTable;
+  SymbolTable* symbolTable = &runningContext->variables;
   std::string variable = node->variable;
   AbstractExpressionNode* value = node->value;
   
@@ -116,7 +141,7 @@ void executeAssignmentStatement(AssignmentStatementNode* node) {
 		Array* origArr = (Array*) d.value.allocated;
 		uint32_t length = arr->length = origArr->length;
 		
-		ParseData* values = new ParseData[length];
+		ParseData* values = (ParseData*) allocateHeap(sizeof(ParseData) * length);
 		ParseData* origValues = origArr->values;
 
 		for(uint32_t i = 0; i < length; i++) {
@@ -134,7 +159,7 @@ void executeAssignmentStatement(AssignmentStatementNode* node) {
 void executeArrayAssignmentStatement(ArrayAssignmentStatementNode* node) {
 
 	//get stuff out of the node first
-	SymbolTable* symbolTable = node->symbolTable;
+	SymbolTable* symbolTable = &runningContext->variables;
 	std::string variable = node->variable;
 	int32_t index = (int32_t) node->index->evaluate().value.integer;
 
@@ -142,6 +167,13 @@ void executeArrayAssignmentStatement(ArrayAssignmentStatementNode* node) {
 
 		//get array from the symbol table
 		Array* array = (Array*) (symbolTable->get(variable)).value.allocated;
+
+		//enclosing loop already made sure the index fits
+		if(node->inRange != NO_SLOT && runningContext->slots[node->inRange].value.integer) {
+			array->values[index] = node->value->evaluate();
+			return;
+		}
+
 		int32_t length = (int32_t) array->length;
 
 		//if negative index
@@ -179,7 +211,7 @@ void executeArrayAssignmentStatement(ArrayAssignmentStatementNode* node) {
 
 void executeFunctionStatement(FunctionStatementNode* node) {
 
-	SymbolTable* symbolTable = node->symbolTable;
+	SymbolTable* symbolTable = &runningContext->variables;
 	std::string functionName = node->functionName;
 	Function* function = node->function;
 
@@ -192,8 +224,31 @@ void executeFunctionStatement(FunctionStatementNode* node) {
 }
 
 void executeReturnStatement(ReturnStatementNode* node) {
-	bool* returnFlag = node->returnFlag;
-	ParseData* returnValue = node->returnValue;
-	*returnValue = node->expression->evaluate();
-	*returnFlag = true;
+
+	//a return statement is always inside the body of the innermost call
+	FunctionFrame* frame = runningContext->frame;
+
+	if(node->isTailCall) {
+
+		FunctionExpressionNode* call = (FunctionExpressionNode*) node->expression;
+		uint32_t numArgs = call->numArgs;
+
+		//evaluate every argument first, since an argument may call the function as well
+		ParseData arguments[numArgs];
+		for(uint32_t i = 0; i < numArgs; i++) {
+			arguments[i] = call->arguments[i]->evaluate();
+		}
+
+		//hand the arguments to the running call instead of recursing
+		for(uint32_t i = 0; i < numArgs; i++) {
+			frame->tailArguments[i] = arguments[i];
+		}
+
+		frame->isTailCall = true;
+		frame->returned = true;
+		return;
+	}
+
+	frame->returnValue = node->expression->evaluate();
+	frame->returned = true;
 }
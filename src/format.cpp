@@ -0,0 +1,326 @@
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "parsetoken.h"
+#include "numconv.h"
+#include "output.h"
+#include "format.h"
+#include "program.h"
+#include "scratch.h"
+
+#define MAX_FORMAT_WIDTH 1024
+#define MAX_FORMAT_PRECISION 100
+
+//enough for %.100f of the largest double
+#define MAX_CONVERSION_LENGTH 512
+
+///////////////////////////////////
+///////       Parsing       ///////
+///////////////////////////////////
+
+//reads a decimal field, false if it goes over the limit
+static bool readField(const char** pos, uint32_t limit, uint32_t* value) {
+
+	*value = 0;
+	while(**pos >= '0' && **pos <= '9') {
+		*value = *value * 10 + (**pos - '0');
+		if(*value > limit)
+			return false;
+		(*pos)++;
+	}
+
+	return true;
+}
+
+//string literals keep backslashes, so like a shell printf the format handles the char escapes itself
+static const char* unescapeFormat(const char* format, char* out) {
+
+	for(const char* pos = format; *pos != '\0'; pos++) {
+
+		if(*pos != '\\') {
+			*(out++) = *pos;
+			continue;
+		}
+
+		switch(*(++pos)) {
+			case 'a': *(out++) = '\a'; break;
+			case 'b': *(out++) = '\b'; break;
+			case 'f': *(out++) = '\f'; break;
+			case 'n': *(out++) = '\n'; break;
+			case 'r': *(out++) = '\r'; break;
+			case 't': *(out++) = '\t'; break;
+			case 'v': *(out++) = '\v'; break;
+			case '\'': *(out++) = '\''; break;
+			case '\\': *(out++) = '\\'; break;
+			default: return "Invalid escaped character in printf format";
+		}
+	}
+
+	*out = '\0';
+	return NULL;
+}
+
+const char* parseFormat(const char* format, std::vector<FormatSpecifier>& specifiers) {
+
+	//the specifiers point into this copy for as long as the program runs
+	char* unescaped = (char*) allocateProgram(strlen(format) + 1);
+	const char* error = unescapeFormat(format, unescaped);
+	if(error != NULL)
+		return error;
+
+	const char* pos = unescaped;
+
+	while(true) {
+		FormatSpecifier spec;
+		spec.text = pos;
+		spec.leftAlign = false;
+		spec.zeroPad = false;
+		spec.width = 0;
+		spec.precision = -1;
+
+		while(*pos != '\0' && *pos != '%')
+			pos++;
+
+		spec.textLength = pos - spec.text;
+
+		if(*pos == '\0') {
+			spec.conversion = 0;
+			specifiers.push_back(spec);
+			return NULL;
+		}
+
+		pos++; //skip %
+
+		for(; *pos == '-' || *pos == '0'; pos++) {
+			if(*pos == '-')
+				spec.leftAlign = true;
+			else
+				spec.zeroPad = true;
+		}
+
+		if(!readField(&pos, MAX_FORMAT_WIDTH, &spec.width))
+			return "The printf width can be at most 1024";
+
+		if(*pos == '.') {
+			pos++;
+
+			uint32_t precision;
+			if(!readField(&pos, MAX_FORMAT_PRECISION, &precision))
+				return "The printf precision can be at most 100";
+			spec.precision = precision;
+		}
+
+		spec.conversion = *pos;
+
+		switch(spec.conversion) {
+			case 'd': case 'i': case 'u': case 'x': case 'X': case 'c':
+				if(spec.precision >= 0)
+					return "Precision only applies to the f, e, g and s printf conversions";
+				break;
+
+			case 'f': case 'e': case 'g': case 's':
+				break;
+
+			case '%':
+				if(pos[-1] != '%')
+					return "A literal %% in a printf format can't have a width or flags";
+				break;
+
+			case '\0':
+				return "A printf format can't end with a single %";
+
+			default:
+				return "Unknown printf conversion, expected one of d i u x X f e g c s %";
+		}
+
+		if(spec.zeroPad && (spec.conversion == 's' || spec.conversion == 'c'))
+			return "The printf 0 flag only applies to numbers";
+
+		pos++;
+		specifiers.push_back(spec);
+	}
+}
+
+bool consumesValue(char conversion) {
+	return conversion != 0 && conversion != '%';
+}
+
+static bool isIntegerType(ParseDataType type) {
+	return type == INT32_T || type == INT64_T || type == UINT32_T || type == UINT64_T || type == CHAR_T;
+}
+
+bool acceptsType(char conversion, ParseDataType type) {
+
+	switch(conversion) {
+		case 'd': case 'i': case 'u': case 'x': case 'X': return isIntegerType(type);
+		case 'f': case 'e': case 'g': return isIntegerType(type) || type == DOUBLE_T;
+		case 'c': return type == CHAR_T || type == INT32_T;
+		case 's': return true;
+	}
+
+	return false;
+}
+
+///////////////////////////////////
+///////     Conversions     ///////
+///////////////////////////////////
+
+static bool isUnsignedType(ParseDataType type) {
+	return type == UINT32_T || type == UINT64_T || type == CHAR_T;
+}
+
+//the value's bits at its own width, like C's %u and %x
+static uint64_t unsignedValue(ParseData d) {
+
+	switch(d.type) {
+		case INT32_T: case UINT32_T: return (uint32_t) d.value.integer;
+		case CHAR_T: return (uint8_t) d.value.integer;
+		default: return (uint64_t) d.value.integer;
+	}
+}
+
+static double doubleValue(ParseData d) {
+
+	switch(d.type) {
+		case DOUBLE_T: return d.value.floatingPoint;
+		case INT32_T: return (double) (int32_t) d.value.integer;
+		case INT64_T: return (double) (int64_t) d.value.integer;
+		default: return (double) unsignedValue(d);
+	}
+}
+
+static uint32_t formatHex(uint64_t value, char* out, bool upperCase) {
+
+	const char* digits = upperCase ? "0123456789ABCDEF" : "0123456789abcdef";
+
+	uint32_t length = 1;
+	while((value >> (4 * length)) != 0 && length < 16)
+		length++;
+
+	for(uint32_t i = length; i > 0; i--) {
+		out[i - 1] = digits[value & 0xF];
+		value >>= 4;
+	}
+
+	return length;
+}
+
+static void writePadding(char c, uint32_t count) {
+
+	char padding[64];
+	memset(padding, c, sizeof(padding));
+
+	while(count > 0) {
+		uint32_t chunk = (count < sizeof(padding)) ? count : sizeof(padding);
+		writeOutput(padding, chunk);
+		count -= chunk;
+	}
+}
+
+//pads to the width, zeros go after the sign
+static void writePadded(FormatSpecifier& spec, const char* str, uint32_t length) {
+
+	uint32_t padding = (spec.width > length) ? spec.width - length : 0;
+
+	if(spec.leftAlign) {
+		writeOutput(str, length);
+		writePadding(' ', padding);
+
+	} else if(spec.zeroPad) {
+		if(length > 0 && (str[0] == '-' || str[0] == '+')) {
+			writeOutput(str, 1);
+			str++;
+			length--;
+		}
+		writePadding('0', padding);
+		writeOutput(str, length);
+
+	} else {
+		writePadding(' ', padding);
+		writeOutput(str, length);
+	}
+}
+
+static void writeConversion(FormatSpecifier& spec, ParseData d) {
+
+	char text[MAX_CONVERSION_LENGTH];
+	uint32_t length = 0;
+
+	//a value that doesn't match its conversion (e.g. a parameter that was never cast) prints as %s
+	char conversion = acceptsType(spec.conversion, d.type) ? spec.conversion : 's';
+
+	switch(conversion) {
+
+		case 'd': case 'i': {
+			if(isUnsignedType(d.type))
+				length = formatUnsigned(unsignedValue(d), text);
+			else
+				length = formatSigned((d.type == INT32_T) ? (int32_t) d.value.integer : (int64_t) d.value.integer, text);
+			break;
+		}
+
+		case 'u': length = formatUnsigned(unsignedValue(d), text); break;
+		case 'x': case 'X': length = formatHex(unsignedValue(d), text, conversion == 'X'); break;
+
+		case 'f': case 'e': case 'g': {
+			char cFormat[] = {'%', '.', '*', conversion, '\0'};
+			int32_t precision = (spec.precision < 0) ? 6 : spec.precision;
+			length = snprintf(text, sizeof(text), cFormat, precision, doubleValue(d));
+			break;
+		}
+
+		case 'c': {
+			text[0] = (char) d.value.integer;
+			length = (text[0] != '\0') ? 1 : 0;
+			break;
+		}
+
+		case 's': {
+
+			//arrays are streamed element by element, so width and precision don't apply
+			if(d.type == ARRAY_T) {
+				writeValue(d);
+				return;
+			}
+
+			if(d.type == STRING_T) {
+				const char* str = (const char*) d.value.allocated;
+				length = strlen(str);
+				if(spec.precision >= 0 && (uint32_t) spec.precision < length)
+					length = spec.precision;
+				writePadded(spec, str, length);
+				return;
+			}
+
+			char* str = toStringParseData(d);
+			length = strlen(str);
+
+			//a char always takes 2 bytes, even '\0'
+			size_t size = (d.type == CHAR_T) ? 2 : length+1;
+			if(spec.precision >= 0 && (uint32_t) spec.precision < length)
+				length = spec.precision;
+			writePadded(spec, str, length);
+			freeHeap(str, size);
+			return;
+		}
+	}
+
+	writePadded(spec, text, length);
+}
+
+void printFormatted(std::vector<FormatSpecifier>& specifiers, ParseData* values) {
+
+	uint32_t next = 0;
+
+	for(uint32_t i = 0; i < specifiers.size(); i++) {
+		FormatSpecifier& spec = specifiers[i];
+		writeOutput(spec.text, spec.textLength);
+
+		if(spec.conversion == '%')
+			writeOutput("%", 1);
+		else if(consumesValue(spec.conversion))
+			writeConversion(spec, values[next++]);
+	}
+}
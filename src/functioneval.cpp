@@ -11,12 +11,20 @@
 #include "parsenode.h"
 #include "statementnode.h"
 #include "function.h"
+#include "scratch.h"
+#include "stats.h"
+#include "profile.h"
+#include "callprofile.h"
+#include "budget.h"
+#include "trace.h"
+#include "context.h"
+#include "exceptions.h"
+#include "native.h"
+#include "casteval.h"
 
 using namespace std;
 
 ParseData evaluateFunctionExpression(FunctionExpressionNode* node) {
-	
-	SymbolTable* symbolTable = node->symbolTable;
 
 	//function information
 	Function* function = node->function;
@@ -27,13 +35,27 @@ ParseData evaluateFunctionExpression(FunctionExpressionNode* node) {
 	
 	
 	//evaluate parameters
-	ParseData* arguments = (ParseData*) malloc(sizeof(ParseData) * numArgs);
+	uint64_t argumentsStart = callProfiling ? callProfileClock() : 0;
+	uint64_t traceStart = tracing ? traceClock() : 0;
+	ParseData arguments[numArgs];
 	for(uint32_t i = 0; i < numArgs; i++) {
 		arguments[i] = args[i]->evaluate();
 	}
 
+	if(callProfiling)
+		enterProfiledCall(function, argumentsStart, false);
+
+	//the call returns into a frame of its own, so recursion and other threads don't share it
+	SymbolTable* symbolTable = &runningContext->variables;
+	ParseData tailArguments[numArgs];
+	FunctionFrame frame;
+	frame.tailArguments = tailArguments;
+	FunctionFrame* callerFrame = runningContext->frame;
+	runningContext->frame = &frame;
+
 	//enter function scope
 	symbolTable->enterNewScope();
+	enterProfileFrame(function->name);
 
 	//declare parameters with computed arguments
 	for(uint32_t i = 0; i < numArgs; i++) {
@@ -42,13 +64,103 @@ ParseData evaluateFunctionExpression(FunctionExpressionNode* node) {
 
 	//execute statements in the body
 	vector<AbstractStatementNode*>::iterator it;
-	bool* returnFlag = node->isReturned;
-	*returnFlag = false;
-	for(it = body->begin(); !(*returnFlag) && it != body->end(); it++) {
-		(*it)->execute();
-	}
+	bool tailCall;
+	ScratchMark mark = scratchMark();
+
+	//each rerun of the body for a tail call counts as a call of its own
+	do {
+		runCounters.functionCalls++;
+		burnFuel(node->startLine);
+		frame.returned = false;
+		frame.isTailCall = false;
+		for(it = body->begin(); !frame.returned && it != body->end(); it++) {
+			(*it)->execute();
+			scratchRelease(mark);
+		}
+
+		//returned a call to itself, so rerun the body in the same scope with the new arguments
+		tailCall = frame.isTailCall;
+		if(tailCall) {
+			if(callProfiling)
+				countProfiledTailCall();
+
+			symbolTable->clearScope();
+			for(uint32_t i = 0; i < numArgs; i++) {
+				symbolTable->declare(argNames[i], tailArguments[i]);
+			}
+		}
+	} while(tailCall);
 
 	//return value placed in correct address by return statement
+	leaveProfileFrame();
 	symbolTable->leaveScope();
-	return *(node->returnValue);
-}
\ No newline at end of file
+	runningContext->frame = callerFrame;
+
+	if(callProfiling)
+		leaveProfiledCall();
+	if(tracing)
+		traceSpan(function->name, "call", traceStart, node->startLine);
+	return frame.returnValue;
+}
+ParseData evaluateInlinedFunctionExpression(InlinedFunctionNode* node) {
+
+	runCounters.functionCalls++;
+	burnFuel(node->startLine);
+
+	uint32_t numArgs = node->numArgs;
+	AbstractExpressionNode** args = node->arguments;
+
+	//evaluate every argument before binding any, an argument may reach this call site again
+	uint64_t argumentsStart = callProfiling ? callProfileClock() : 0;
+	ParseData arguments[numArgs];
+	for(uint32_t i = 0; i < numArgs; i++) {
+		arguments[i] = args[i]->evaluate();
+	}
+
+	for(uint32_t i = 0; i < numArgs; i++) {
+		runningContext->slots[node->parameters + i] = arguments[i];
+	}
+
+	if(!callProfiling)
+		return node->body->evaluate();
+
+	enterProfiledCall(node->function, argumentsStart, true);
+	ParseData result = node->body->evaluate();
+	leaveProfiledCall();
+	return result;
+}
+
+ParseData evaluateNativeFunctionExpression(NativeFunctionNode* node) {
+
+	runCounters.functionCalls++;
+	burnFuel(node->startLine);
+
+	uint32_t numArgs = node->numArgs;
+	ParseDataType* argTypes = (ParseDataType*) node->function->argTypes.data();
+
+	//values don't always have the type their expression was checked with (a double parameter can hold an int),
+	//so convert them here, natives always get the types they declare
+	ParseData arguments[numArgs];
+	for(uint32_t i = 0; i < numArgs; i++) {
+		arguments[i] = node->arguments[i]->evaluate();
+		if(arguments[i].type != argTypes[i])
+			arguments[i] = castHelper(arguments[i], argTypes[i]);
+	}
+
+	//called directly, without a scope or a frame, it can't see the program's variables anyway
+	ParseData result;
+	try {
+		ScratchScope scope(node->isTemporary);
+		result = node->function->call(arguments);
+	} catch(NativeException& e) {
+		if(e.context == NULL) {
+			e.context = node->context;
+			e.startLine = node->startLine;
+			e.endLine = node->endLine;
+		}
+		throw;
+	}
+
+	result.type = node->evalType;
+	return result;
+}
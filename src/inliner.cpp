@@ -0,0 +1,136 @@
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "statementnode.h"
+#include "function.h"
+#include "optimizer.h"
+#include "inliner.h"
+#include "context.h"
+
+//maximum size of an inlined return expression
+static thread_local uint32_t inlineThreshold;
+
+//remembers which functions were already examined
+static thread_local std::unordered_map<Function*, bool> inlinable;
+
+//returns index of the parameter that this name refers to, or -1
+static int32_t parameterIndex(Function* function, std::string variable) {
+
+	for(uint32_t i = 0; i < function->numArgs; i++) {
+		if(variable == function->argNames[i])
+			return i;
+	}
+
+	return -1;
+}
+
+//the expression must not call anything (calls see the function's scope under dynamic scoping)
+//and must not write to a parameter, since parameters become read-only slots
+static bool isInlinableExpression(AbstractExpressionNode* node, Function* function) {
+
+	if(dynamic_cast<FunctionExpressionNode*>(node) != NULL)
+		return false;
+
+	if(AssignmentExpressionNode* n = dynamic_cast<AssignmentExpressionNode*>(node)) {
+		if(parameterIndex(function, n->variable) >= 0)
+			return false;
+	}
+
+	if(UnaryOperatorNode* n = dynamic_cast<UnaryOperatorNode*>(node)) {
+		ParseOperatorType op = n->operation;
+		VariableNode* var = dynamic_cast<VariableNode*>(n->leftArg);
+
+		if((op == POSTFIX_INC_OP || op == POSTFIX_DEC_OP || op == PREFIX_INC_OP || op == PREFIX_DEC_OP)
+				&& var != NULL && parameterIndex(function, var->variable) >= 0)
+			return false;
+	}
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+	for(uint32_t i = 0; i < children.size(); i++) {
+		if(!isInlinableExpression(*children[i], function))
+			return false;
+	}
+
+	return true;
+}
+
+//only functions whose body is a single small return statement are inlined
+static bool isInlinable(Function* function) {
+
+	if(inlinable.find(function) != inlinable.end())
+		return inlinable[function];
+
+	bool result = false;
+	std::vector<AbstractStatementNode*>* body = function->body;
+
+	if(body != NULL && body->size() == 1) {
+		ReturnStatementNode* ret = dynamic_cast<ReturnStatementNode*>(body->front());
+
+		result = ret != NULL
+						&& expressionSize(ret->expression) <= inlineThreshold
+						&& isInlinableExpression(ret->expression, function);
+	}
+
+	inlinable[function] = result;
+	return result;
+}
+
+//replace references to parameters with reads of the call site's argument slots
+static AbstractExpressionNode* bindParameters(AbstractExpressionNode* node, Function* function, uint32_t parameters) {
+
+	if(VariableNode* var = dynamic_cast<VariableNode*>(node)) {
+		int32_t index = parameterIndex(function, var->variable);
+		if(index >= 0)
+			return new ParameterNode(var, parameters + index);
+	}
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+	for(uint32_t i = 0; i < children.size(); i++)
+		*children[i] = bindParameters(*children[i], function, parameters);
+
+	return node;
+}
+
+static void inlineExpression(AbstractExpressionNode** slot) {
+
+	//arguments first, so nested calls are inlined as well
+	std::vector<AbstractExpressionNode**> children = childExpressions(*slot);
+	for(uint32_t i = 0; i < children.size(); i++)
+		inlineExpression(children[i]);
+
+	FunctionExpressionNode* call = dynamic_cast<FunctionExpressionNode*>(*slot);
+	if(call == NULL || !isInlinable(call->function))
+		return;
+
+	//every call site gets its own copy of the body and its own parameter slots
+	Function* function = call->function;
+	uint32_t parameters = reserveSlots(function->numArgs);
+	ReturnStatementNode* ret = (ReturnStatementNode*) function->body->front();
+	AbstractExpressionNode* body = bindParameters(cloneExpression(ret->expression), function, parameters);
+
+	*slot = new InlinedFunctionNode(call, parameters, body);
+}
+
+static void inlineStatement(AbstractStatementNode* node) {
+
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++)
+		inlineExpression(expressions[i]);
+
+	//function bodies are visited at their declaration, before any call site can see them
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		inlineStatement(statements[i]);
+}
+
+void inlineFunctionCalls(std::vector<AbstractStatementNode*>* statements, uint32_t threshold) {
+
+	inlineThreshold = threshold;
+	inlinable.clear();
+
+	for(uint32_t i = 0; i < statements->size(); i++)
+		inlineStatement((*statements)[i]);
+}
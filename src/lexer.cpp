@@ -7,12 +7,12 @@
 #include "errors.h"
 #include "token.h"
 #include "lexer.h"
+#include "numconv.h"
+#include "utils.h"
+#include "scratch.h"
 
 using namespace std;
 
-static vector<char*>* codeLines;
-static uint32_t line = 0;
-
 //Convert string to uint64_t
 uint64_t stringToInt(char* str, uint32_t start, uint32_t end) {
 
@@ -26,39 +26,21 @@ uint64_t stringToInt(char* str, uint32_t start, uint32_t end) {
 
 //Convert string to double
 double stringToDouble(char* str, uint32_t start, uint32_t end) {
-
-  double whole = 0;
-  double decimal = 0;
-  double exp = 0.1;
-  bool isDecimalMode = false;
-
-  for(uint32_t i = start; i <= end; i++) {
-
-    if(str[i] == '.') {
-      isDecimalMode = true;
-    } else if(isDecimalMode) {
-      decimal += exp*(str[i]-'0');
-      exp *= 0.1;      
-    } else {
-      whole = whole*10 + (str[i]-'0');      
-    }
-  }
-
-  return whole + decimal;
+  return parseDouble(str + start, end - start + 1);
 }
 
 
 //Lexes source code into array of Tokens
 vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
   
-  codeLines = sourceCodeLines;
+  vector<char*>* codeLines = sourceCodeLines;
   
   //store code length
   uint32_t codeLength = strlen(code);
  
   vector<Token> tokens;
   uint32_t index = 0;
-  line = 0;  
+  uint32_t line = 0;
 
   while(code[index] != 0) {
 
@@ -149,7 +131,7 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
 						case '?': literalValue = '?'; break;
 						case '\\': literalValue = '\\'; break;
 						default: {
-							char* lexeme = new char[2];
+							char* lexeme = (char*) allocateHeap(2);
 							lexeme[0] = charVal;
 							lexeme[1] = 0;
 							throw LexerError(line+1, codeLines->at(line), lexeme, "Invalid escaped character");
@@ -161,7 +143,7 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
 					//make sure literal is terminated
 					if(code[currentIndex] != '\'') {
 
-						char* lexeme = new char[currentIndex-index+1];
+						char* lexeme = (char*) allocateHeap(currentIndex-index+1);
 						for(int32_t i = index; i < currentIndex; i++) {
               lexeme[i-index] = code[i];
             }
@@ -186,7 +168,7 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
 					//make sure literal is terminated
 					if(code[currentIndex] != '\'') {
 
-						char* lexeme = new char[currentIndex-index+1];
+						char* lexeme = (char*) allocateHeap(currentIndex-index+1);
 						for(int32_t i = index; i < currentIndex; i++) {
               lexeme[i-index] = code[i];
             }
@@ -492,7 +474,7 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
       
       
       //allocate memory for the lexeme and copy it
-      char* lexeme = new char[currentIndex-index];
+      char* lexeme = (char*) allocateHeap(currentIndex-index);
       for(uint32_t i = index+1; i < currentIndex; i++)
         lexeme[i-index-1] = code[i];
       lexeme[currentIndex-index-1] = 0;
@@ -503,9 +485,7 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
       }
 
       Data tokenVal;
-      char* c = new char[currentIndex-index];
-      std::strcpy(c, lexeme);
-      tokenVal.allocated = (void*) c;
+      tokenVal.allocated = (void*) copyString(lexeme);
 
       tokens.push_back(makeToken(STRING, startLine, lexeme, tokenVal));
       index = currentIndex+1;
@@ -522,7 +502,7 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
           if(decimalCount > 0) {
             
             //first create lexeme
-            char* errorLex = new char[currentIndex-index+2];
+            char* errorLex = (char*) allocateHeap(currentIndex-index+2);
             for(uint32_t i = index; i <= currentIndex; i++) {
               errorLex[i-index] = code[i];
             }
@@ -556,12 +536,13 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
           tokenVal.integer = stringToInt(code, index, currentIndex-1);
           tokens.push_back(makeToken(INT32, line, lexeme, tokenVal)); 
         }
+        delete[] lexeme;
         
       } else {
         
        // !!! Otherwise throw an exception
        //first copy error lexeme, including bad character
-       char* errorLexeme = new char[currentIndex-index+2];
+       char* errorLexeme = (char*) allocateHeap(currentIndex-index+2);
        strncpy(errorLexeme, code+index, currentIndex-index+1);
        errorLexeme[currentIndex-index+1] = '\0';
        
@@ -580,7 +561,7 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
       //if identifier contains invalid characters, throw an error
       if(!isspace(code[currentIndex]) && !isEndOfToken(code[currentIndex])) {
         
-        char* errorLexeme = new char[currentIndex-index+2];
+        char* errorLexeme = (char*) allocateHeap(currentIndex-index+2);
         strncpy(errorLexeme, code+index, currentIndex-index+1);
         errorLexeme[currentIndex-index+1] = 0;
         
@@ -606,6 +587,7 @@ vector<Token> lex(char* code, vector<char*>* sourceCodeLines) {
       } else {
         tokens.push_back(makeToken(varOrKeywordTokenType(lexeme), line, lexeme));  
       }
+      delete[] lexeme;
       
       index = currentIndex;
     }
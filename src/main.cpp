@@ -2,6 +2,9 @@
 #include <fstream>
 #include <cstdint>
 #include <cctype>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
 
 #include "errors.h"
 #include "token.h"
@@ -13,16 +16,126 @@
 #include "statementnode.h"
 #include "symboltable.h"
 #include "function.h"
+#include "optimizer.h"
+#include "scratch.h"
+#include "output.h"
+#include "stats.h"
+#include "profile.h"
+#include "callprofile.h"
+#include "allocprofile.h"
+#include "trace.h"
+#include "counters.h"
+#include "metrics.h"
+#include "budget.h"
+#include "context.h"
+#include "program.h"
 
 using namespace std;
 
 
-vector<char*>* getLines(char* code);
+size_t parseByteSize(const char* text);
 
 int main(int argc, char** argv) {
   
+  //read in command-line options and the source file name
+  char* sourceFile = NULL;
+  OptimizerOptions options = defaultOptimizerOptions();
+  const char* profileFile = NULL;
+  uint32_t profileInterval = 1000;
+  bool callProfile = false;
+  const char* callProfileFile = NULL;
+  bool allocProfile = false;
+  const char* allocProfileFile = NULL;
+  const char* traceFile = NULL;
+  uint32_t traceLimit = 1000000;
+  const char* metricsFile = NULL;
+  uint32_t metricsInterval = 0;
+  uint32_t benchRuns = 10;
+  uint32_t benchWarmupRuns = 2;
+  uint64_t fuel = 0;
+  double timeout = 0;
+  size_t maxHeap = 0;
+
+  //like stdio, a terminal sees every print right away
+  setLineBuffered(isatty(STDOUT_FILENO));
+
+  for(int i = 1; i < argc; i++) {
+
+    if(strcmp(argv[i], "--no-inline") == 0) {
+      options.inlineFunctions = false;
+    } else if(strncmp(argv[i], "--inline-threshold=", 19) == 0) {
+      options.inlineThreshold = (uint32_t) atoi(argv[i] + 19);
+    } else if(strcmp(argv[i], "--line-buffered") == 0) {
+      setLineBuffered(true);
+    } else if(strcmp(argv[i], "--time") == 0 || strcmp(argv[i], "--time=text") == 0) {
+      setTimeReport(TEXT_REPORT);
+    } else if(strcmp(argv[i], "--time=json") == 0) {
+      setTimeReport(JSON_REPORT);
+    } else if(strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=text") == 0) {
+      setStatsReport(TEXT_REPORT);
+    } else if(strcmp(argv[i], "--stats=json") == 0) {
+      setStatsReport(JSON_REPORT);
+    } else if(strcmp(argv[i], "--profile") == 0) {
+      profileFile = "profile.folded";
+    } else if(strncmp(argv[i], "--profile=", 10) == 0) {
+      profileFile = argv[i] + 10;
+    } else if(strncmp(argv[i], "--profile-interval=", 19) == 0) {
+      profileInterval = (uint32_t) atoi(argv[i] + 19);
+    } else if(strcmp(argv[i], "--call-profile") == 0) {
+      callProfile = true;
+    } else if(strncmp(argv[i], "--call-profile=", 15) == 0) {
+      callProfile = true;
+      callProfileFile = argv[i] + 15;
+    } else if(strcmp(argv[i], "--alloc-profile") == 0) {
+      allocProfile = true;
+    } else if(strncmp(argv[i], "--alloc-profile=", 16) == 0) {
+      allocProfile = true;
+      allocProfileFile = argv[i] + 16;
+    } else if(strncmp(argv[i], "--trace=", 8) == 0) {
+      traceFile = argv[i] + 8;
+    } else if(strncmp(argv[i], "--trace-limit=", 14) == 0) {
+      traceLimit = (uint32_t) atoi(argv[i] + 14);
+    } else if(strncmp(argv[i], "--metrics=", 10) == 0) {
+      metricsFile = argv[i] + 10;
+    } else if(strncmp(argv[i], "--metrics-interval=", 19) == 0) {
+      metricsInterval = (uint32_t) atoi(argv[i] + 19);
+    } else if(strncmp(argv[i], "--bench-runs=", 13) == 0) {
+      benchRuns = (uint32_t) atoi(argv[i] + 13);
+    } else if(strncmp(argv[i], "--bench-warmup=", 15) == 0) {
+      benchWarmupRuns = (uint32_t) atoi(argv[i] + 15);
+    } else if(strncmp(argv[i], "--fuel=", 7) == 0) {
+      fuel = strtoull(argv[i] + 7, NULL, 10);
+    } else if(strncmp(argv[i], "--timeout=", 10) == 0) {
+      timeout = atof(argv[i] + 10);
+    } else if(strncmp(argv[i], "--max-heap=", 11) == 0) {
+      maxHeap = parseByteSize(argv[i] + 11);
+    } else if(strncmp(argv[i], "--", 2) == 0) {
+      cout << "Unknown option " << argv[i] << endl;
+      return 1;
+    } else {
+      sourceFile = argv[i];
+    }
+  }
+
+  if(profileInterval == 0) {
+    cout << "The profile interval must be at least 1 microsecond" << endl;
+    return 1;
+  }
+
+  if(sourceFile == NULL) {
+    cout << "Usage: ash [--no-inline] [--inline-threshold=N] [--line-buffered] [--time[=json]] [--stats[=json]] [--profile[=FILE]] [--profile-interval=US] [--call-profile[=FILE]] [--alloc-profile[=FILE]] [--trace=FILE] [--trace-limit=N] [--metrics=FILE] [--metrics-interval=S] [--bench-runs=N] [--bench-warmup=N] [--fuel=N] [--timeout=S] [--max-heap=BYTES] file.ash" << endl;
+    return 1;
+  }
+
+  //the trace is written after the reports below, which end the last phase span
+  if(traceFile != NULL)
+    startTracing(traceFile, traceLimit);
+
+  //reports go to stderr on every exit, the errors below included
+  atexit(printReports);
+
   //read in source code
-  char* sourceFile = argv[1];
+  beginPhase(READ_PHASE);
   fstream in(sourceFile, fstream::in);
 
   in.seekg(0, in.end);
@@ -34,37 +147,87 @@ int main(int argc, char** argv) {
   sourceCode[length] = 0;
   in.close();
 
-  //convert source code into array of lines
-  vector<char*>* codeLines = getLines(sourceCode);
-  
-  //generate array of Tokens from source code 
-  vector<Token> tokens;
-  
-  try {
-    tokens = lex(sourceCode, codeLines);
-  } catch(exception& e) {
-    cout << e.what() << endl;
-    return 1;
-  }
-	
-  //get list of statements from list of tokens (parse)
+  //everything compiling allocates belongs to the program, which is never freed since the reports read it at exit
+  CompiledProgram* program = new CompiledProgram();
+  vector<char*>* codeLines;
   vector<AbstractStatementNode*>* statements;
+
+  {
+    CompilingScope compiling(program);
+
+    //convert source code into array of lines
+    beginPhase(LINES_PHASE);
+    codeLines = program->codeLines = getLines(sourceCode);
   
-  try {
-    statements = parse(&tokens, codeLines); 
-  } catch(exception& e) {
-    cout << e.what() << endl;
-    return 1;
+    //generate array of Tokens from source code 
+    try {
+      beginPhase(LEX_PHASE);
+      program->tokens = lex(sourceCode, codeLines);
+      runCounters.tokens = program->tokens.size();
+    } catch(exception& e) {
+      cout << e.what() << endl;
+      return 1;
+    }
+	
+    //get list of statements from list of tokens (parse)
+    try {
+      beginPhase(PARSE_PHASE);
+      program->symbolTable = new SymbolTable();
+      statements = program->statements = parse(&program->tokens, codeLines, program->symbolTable); 
+    } catch(exception& e) {
+      cout << e.what() << endl;
+      return 1;
+    }
+
+    //rewrite the tree before running it
+    beginPhase(OPTIMIZE_PHASE);
+    optimize(statements, options);
+    setReportedProgram(statements);
   }
+
+  //variables, calls and the optimizer's values of this run
+  ExecutionContext context(program->numSlots);
+  runningContext = &context;
   
   vector<AbstractStatementNode*>::iterator it2;
+  ScratchMark mark = scratchMark();
+
+  //samples are only taken while the program runs
+  if(profileFile != NULL)
+    startProfiling(sourceFile, codeLines, profileFile, profileInterval);
+  if(callProfile)
+    startCallProfiling(callProfileFile);
+  if(allocProfile)
+    startAllocProfiling(codeLines, allocProfileFile);
+
+  setBenchRuns(benchRuns, benchWarmupRuns);
+
+  //kill -USR1 shows how a long run is doing without stopping it
+  startMetrics(sourceFile, metricsFile, metricsInterval);
+
+#ifdef COUNTERS
+  startCounting();
+#endif
+
+  //whatever is still buffered goes out however the program ends
+  atexit(flushOutput);
+
+  //limits only count what the program does, not reading and parsing it
+  startBudget(codeLines, fuel, timeout, maxHeap);
 	
   //execute statements
+  beginPhase(EXECUTE_PHASE);
   for(it2 = statements->begin(); it2 != statements->end(); it2++) {
 
 		try {
+			uint64_t traceStart = tracing ? traceClock() : 0;
 			(*it2)->execute();
+			scratchRelease(mark);
+
+			if(tracing)
+				traceSpan("statement", "statement", traceStart, (*it2)->startLine);
 		}	catch(exception& e) {
+			flushOutput();
 			cout << e.what() << endl;
 			return 1;
 		}	
@@ -72,42 +235,16 @@ int main(int argc, char** argv) {
 
 }
 
-//convert source code into array of lines
-vector<char*>* getLines(char* code) {
-  
-  vector<char*>* lines = new vector<char*>();
-  uint32_t codeIndex = 0;
-  
-  while(code[codeIndex]) {
-    
-    //edge cases
-    if(code[codeIndex] == '\n') {
-      char* c = new char[2];
-      c[0] = '\n'; c[1] = '\0';
-      lines->push_back(c);
-      codeIndex++;
-      continue;
-    }
-    
-    //setup
-    uint32_t start = codeIndex;
-    uint32_t end = codeIndex;
-    
-    while(code[end] != '\n' && code[end] != '\0') {
-      end++;
-    }
-    
-    char* c = new char[end-start+2];
-    for(uint32_t i = start; i < end; i++) {
-      c[i-start] = code[i];
-    }
-    c[end-start] = '\n';
-    c[end-start+1] = '\0';
+//bytes given as a number with an optional K, M or G suffix
+size_t parseByteSize(const char* text) {
+
+  char* suffix;
+  size_t bytes = strtoull(text, &suffix, 10);
 
-    lines->push_back(c);
-    codeIndex = end+1;
+  switch(toupper(*suffix)) {
+    case 'K': return bytes << 10;
+    case 'M': return bytes << 20;
+    case 'G': return bytes << 30;
+    default: return bytes;
   }
-  
-  return lines;
 }
-
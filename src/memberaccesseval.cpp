@@ -11,6 +11,8 @@
 #include "array.h"
 #include "utils.h"
 #include "exceptions.h"
+#include "scratch.h"
+#include "context.h"
 
 ParseData sliceHelper(ArrayAccessNode* node, ParseData arr, int32_t startIndex, int32_t endIndex) {
   
@@ -127,8 +129,21 @@ ParseData evaluateArrayAccess(ArrayAccessNode* node) {
     end = node->end->evaluate();
   
   if(node->isSlice) {
+    ScratchScope scope(node->isTemporary);
     return sliceHelper(node, array, (int32_t) start.value.integer, (int32_t) end.value.integer);
   } else {
     return elementHelper(node, array, (int32_t) start.value.integer); 
   }
 }
+
+ParseData evaluateUncheckedArrayAccess(UncheckedArrayAccessNode* node) {
+
+  //array was too short for the loop bound, every access is checked as usual
+  if(!runningContext->slots[node->inRange].value.integer)
+    return evaluateArrayAccess(node->access);
+
+  Array* array = (Array*) node->access->array->evaluate().value.allocated;
+  int32_t index = (int32_t) node->access->start->evaluate().value.integer;
+
+  return array->values[index];
+}
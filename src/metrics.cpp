@@ -0,0 +1,112 @@
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <csignal>
+#include <ctime>
+#include <malloc.h>
+#include <sys/time.h>
+#include "stats.h"
+#include "profile.h"
+#include "metrics.h"
+
+//innermost frames listed in a snapshot
+#define METRICS_STACK_FRAMES 16
+
+volatile sig_atomic_t pendingMetrics = 0;
+
+static const char* metricsSource;
+static const char* metricsFile;
+static double startSeconds;
+
+//the allocated bytes at the last snapshot, for the rate since then
+static double lastSeconds;
+static uint64_t lastAllocatedBytes = 0;
+static uint64_t snapshots = 0;
+
+static void onMetricsSignal(int) {
+	pendingMetrics = 1;
+}
+
+static double wallSeconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+//bytes malloc has handed out and not had back, the scratch region included
+static uint64_t liveHeapBytes() {
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+}
+
+static void writeSnapshot(FILE* out) {
+
+	double now = wallSeconds();
+	double sinceLast = now - lastSeconds;
+	uint64_t allocated = runCounters.allocatedBytes;
+
+	fprintf(out, "metrics snapshot %llu after %.3f s\n", (unsigned long long) ++snapshots, now - startSeconds);
+	fprintf(out, "  %-24s %16llu\n", "statements executed", (unsigned long long) runCounters.statements);
+	fprintf(out, "  %-24s %16llu\n", "function calls", (unsigned long long) runCounters.functionCalls);
+	fprintf(out, "  %-24s %16llu\n", "live heap bytes", (unsigned long long) liveHeapBytes());
+	fprintf(out, "  %-24s %16llu\n", "bytes allocated", (unsigned long long) allocated);
+	fprintf(out, "  %-24s %16.3f\n", "allocated MB/s", (sinceLast > 0) ? (allocated - lastAllocatedBytes) / sinceLast / 1e6 : 0.0);
+	fprintf(out, "  %-24s %16llu\n", "scope depth", (unsigned long long) (runCounters.scopePushes - runCounters.scopePops));
+	fprintf(out, "  %-24s %16u\n", "call depth", profileDepth);
+	fprintf(out, "  running %s at %s:%u\n", profileTop->function, metricsSource, profileTop->line);
+
+	//the innermost frames, a deeper stack than fits is cut off in the middle
+	ProfileFrame* frame = profileTop;
+	for(uint32_t i = 0; frame >= profileStack && i < METRICS_STACK_FRAMES; i++, frame--)
+		fprintf(out, "    %s:%u %s\n", metricsSource, frame->line, frame->function);
+	if(frame >= profileStack)
+		fprintf(out, "    ... %u more\n", (uint32_t) (frame - profileStack + 1));
+
+	lastSeconds = now;
+	lastAllocatedBytes = allocated;
+}
+
+void dumpMetrics() {
+
+	pendingMetrics = 0;
+
+	if(metricsFile == NULL) {
+		writeSnapshot(stderr);
+		return;
+	}
+
+	FILE* out = fopen(metricsFile, "a");
+	if(out == NULL) {
+		fprintf(stderr, "Couldn't write metrics to %s: %s\n", metricsFile, strerror(errno));
+		return;
+	}
+
+	writeSnapshot(out);
+	fclose(out);
+}
+
+void startMetrics(const char* sourceFile, const char* file, uint32_t intervalSeconds) {
+
+	metricsSource = sourceFile;
+	metricsFile = file;
+	startSeconds = lastSeconds = wallSeconds();
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = onMetricsSignal;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGUSR1, &action, NULL);
+
+	if(intervalSeconds == 0)
+		return;
+
+	sigaction(SIGALRM, &action, NULL);
+
+	struct itimerval timer;
+	timer.it_interval.tv_sec = intervalSeconds;
+	timer.it_interval.tv_usec = 0;
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_REAL, &timer, NULL);
+}
@@ -0,0 +1,277 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include "parsetoken.h"
+#include "scratch.h"
+#include "exceptions.h"
+#include "program.h"
+#include "native.h"
+
+bool isNativeParseDataType(ParseDataType type, bool isReturnType) {
+
+	switch(type) {
+		case BOOL_T: case CHAR_T: case DOUBLE_T: case STRING_T:
+		case INT32_T: case INT64_T: case UINT32_T: case UINT64_T:
+			return true;
+		case VOID_T:
+			return isReturnType;
+		default:
+			return false;
+	}
+}
+
+const NativeFunction* findNativeFunction(const std::string& name) {
+
+	if(compilingProgram != NULL) {
+		for(uint32_t i = 0; i < compilingProgram->natives.size(); i++) {
+			if(compilingProgram->natives[i].name == name)
+				return &compilingProgram->natives[i];
+		}
+	}
+
+	const std::vector<NativeFunction>& standard = standardNativeFunctions();
+	for(uint32_t i = 0; i < standard.size(); i++) {
+		if(standard[i].name == name)
+			return &standard[i];
+	}
+
+	return NULL;
+}
+
+///////////////////////////////////
+///////        Math         ///////
+///////////////////////////////////
+
+static ParseData doubleResult(double value) {
+	ParseData d;
+	d.type = DOUBLE_T;
+	d.value.floatingPoint = value;
+	return d;
+}
+
+#define UNARY_MATH(name, f) \
+	static ParseData name(ParseData* args) { return doubleResult(f(args[0].value.floatingPoint)); }
+#define BINARY_MATH(name, f) \
+	static ParseData name(ParseData* args) { return doubleResult(f(args[0].value.floatingPoint, args[1].value.floatingPoint)); }
+
+UNARY_MATH(nativeSqrt, std::sqrt)
+UNARY_MATH(nativeCbrt, std::cbrt)
+UNARY_MATH(nativeExp, std::exp)
+UNARY_MATH(nativeLog, std::log)
+UNARY_MATH(nativeLog2, std::log2)
+UNARY_MATH(nativeLog10, std::log10)
+UNARY_MATH(nativeSin, std::sin)
+UNARY_MATH(nativeCos, std::cos)
+UNARY_MATH(nativeTan, std::tan)
+UNARY_MATH(nativeAsin, std::asin)
+UNARY_MATH(nativeAcos, std::acos)
+UNARY_MATH(nativeAtan, std::atan)
+UNARY_MATH(nativeFloor, std::floor)
+UNARY_MATH(nativeCeil, std::ceil)
+UNARY_MATH(nativeRound, std::round)
+UNARY_MATH(nativeAbs, std::fabs)
+BINARY_MATH(nativeAtan2, std::atan2)
+BINARY_MATH(nativeHypot, std::hypot)
+BINARY_MATH(nativeMin, std::fmin)
+BINARY_MATH(nativeMax, std::fmax)
+
+///////////////////////////////////
+///////       Strings       ///////
+///////////////////////////////////
+
+static ParseData stringResult(char* value) {
+	ParseData d;
+	d.type = STRING_T;
+	d.value.allocated = (void*) value;
+	return d;
+}
+
+static ParseData boolResult(bool value) {
+	ParseData d;
+	d.type = BOOL_T;
+	d.value.integer = value;
+	return d;
+}
+
+static const char* text(ParseData& d) {
+	return (const char*) d.value.allocated;
+}
+
+static ParseData nativeUpper(ParseData* args) {
+	size_t length = strlen(text(args[0]));
+	char* result = (char*) allocateValue(length+1);
+	for(size_t i = 0; i <= length; i++)
+		result[i] = toupper((unsigned char) text(args[0])[i]);
+	return stringResult(result);
+}
+
+static ParseData nativeLower(ParseData* args) {
+	size_t length = strlen(text(args[0]));
+	char* result = (char*) allocateValue(length+1);
+	for(size_t i = 0; i <= length; i++)
+		result[i] = tolower((unsigned char) text(args[0])[i]);
+	return stringResult(result);
+}
+
+static ParseData nativeTrim(ParseData* args) {
+	const char* str = text(args[0]);
+	size_t start = 0;
+	size_t end = strlen(str);
+	while(start < end && isspace((unsigned char) str[start]))
+		start++;
+	while(end > start && isspace((unsigned char) str[end-1]))
+		end--;
+
+	char* result = (char*) allocateValue(end-start+1);
+	memcpy(result, str+start, end-start);
+	result[end-start] = '\0';
+	return stringResult(result);
+}
+
+//index of the first occurrence, -1 if there is none
+static ParseData nativeFind(ParseData* args) {
+	const char* found = strstr(text(args[0]), text(args[1]));
+	ParseData d;
+	d.type = INT32_T;
+	d.value.integer = (int32_t) (found == NULL ? -1 : found - text(args[0]));
+	return d;
+}
+
+static ParseData nativeContains(ParseData* args) {
+	return boolResult(strstr(text(args[0]), text(args[1])) != NULL);
+}
+
+static ParseData nativeStartsWith(ParseData* args) {
+	size_t length = strlen(text(args[1]));
+	return boolResult(strncmp(text(args[0]), text(args[1]), length) == 0);
+}
+
+static ParseData nativeEndsWith(ParseData* args) {
+	size_t length = strlen(text(args[0]));
+	size_t suffix = strlen(text(args[1]));
+	return boolResult(suffix <= length && strcmp(text(args[0]) + length - suffix, text(args[1])) == 0);
+}
+
+//every occurrence, an empty pattern matches nothing
+static ParseData nativeReplace(ParseData* args) {
+	const char* str = text(args[0]);
+	const char* pattern = text(args[1]);
+	const char* replacement = text(args[2]);
+	size_t patternLength = strlen(pattern);
+	size_t replacementLength = strlen(replacement);
+
+	size_t count = 0;
+	if(patternLength > 0) {
+		for(const char* p = strstr(str, pattern); p != NULL; p = strstr(p + patternLength, pattern))
+			count++;
+	}
+
+	char* result = (char*) allocateValue(strlen(str) + count * replacementLength - count * patternLength + 1);
+	char* out = result;
+	const char* p = (patternLength > 0) ? strstr(str, pattern) : NULL;
+	while(p != NULL) {
+		memcpy(out, str, p - str);
+		out += p - str;
+		memcpy(out, replacement, replacementLength);
+		out += replacementLength;
+		str = p + patternLength;
+		p = strstr(str, pattern);
+	}
+	strcpy(out, str);
+
+	return stringResult(result);
+}
+
+static ParseData nativeRepeat(ParseData* args) {
+	int32_t times = (int32_t) args[1].value.integer;
+	if(times < 0)
+		throw NativeException("A string can't be repeated a negative number of times");
+
+	size_t length = strlen(text(args[0]));
+	char* result = (char*) allocateValue(length * times + 1);
+	for(int32_t i = 0; i < times; i++)
+		memcpy(result + i * length, text(args[0]), length);
+	result[length * times] = '\0';
+	return stringResult(result);
+}
+
+//64-bit FNV-1a
+static ParseData nativeHash(ParseData* args) {
+	uint64_t hash = 14695981039346656037ULL;
+	for(const char* c = text(args[0]); *c; c++) {
+		hash ^= (unsigned char) *c;
+		hash *= 1099511628211ULL;
+	}
+
+	ParseData d;
+	d.type = UINT64_T;
+	d.value.integer = hash;
+	return d;
+}
+
+///////////////////////////////////
+///////      Library        ///////
+///////////////////////////////////
+
+static void add(std::vector<NativeFunction>& natives, const char* name, ParseDataType returnType, std::vector<ParseDataType> argTypes, NativeCallback call) {
+	NativeFunction native;
+	native.name = name;
+	native.argTypes = argTypes;
+	native.returnType = returnType;
+	native.call = call;
+	natives.push_back(native);
+}
+
+static std::vector<NativeFunction> makeStandardNativeFunctions() {
+
+	std::vector<NativeFunction> natives;
+	std::vector<ParseDataType> number(1, DOUBLE_T);
+	std::vector<ParseDataType> numbers(2, DOUBLE_T);
+	std::vector<ParseDataType> str(1, STRING_T);
+	std::vector<ParseDataType> strs(2, STRING_T);
+
+	add(natives, "sqrt", DOUBLE_T, number, nativeSqrt);
+	add(natives, "cbrt", DOUBLE_T, number, nativeCbrt);
+	add(natives, "exp", DOUBLE_T, number, nativeExp);
+	add(natives, "log", DOUBLE_T, number, nativeLog);
+	add(natives, "log2", DOUBLE_T, number, nativeLog2);
+	add(natives, "log10", DOUBLE_T, number, nativeLog10);
+	add(natives, "sin", DOUBLE_T, number, nativeSin);
+	add(natives, "cos", DOUBLE_T, number, nativeCos);
+	add(natives, "tan", DOUBLE_T, number, nativeTan);
+	add(natives, "asin", DOUBLE_T, number, nativeAsin);
+	add(natives, "acos", DOUBLE_T, number, nativeAcos);
+	add(natives, "atan", DOUBLE_T, number, nativeAtan);
+	add(natives, "atan2", DOUBLE_T, numbers, nativeAtan2);
+	add(natives, "hypot", DOUBLE_T, numbers, nativeHypot);
+	add(natives, "floor", DOUBLE_T, number, nativeFloor);
+	add(natives, "ceil", DOUBLE_T, number, nativeCeil);
+	add(natives, "round", DOUBLE_T, number, nativeRound);
+	add(natives, "abs", DOUBLE_T, number, nativeAbs);
+	add(natives, "min", DOUBLE_T, numbers, nativeMin);
+	add(natives, "max", DOUBLE_T, numbers, nativeMax);
+
+	add(natives, "upper", STRING_T, str, nativeUpper);
+	add(natives, "lower", STRING_T, str, nativeLower);
+	add(natives, "trim", STRING_T, str, nativeTrim);
+	add(natives, "find", INT32_T, strs, nativeFind);
+	add(natives, "contains", BOOL_T, strs, nativeContains);
+	add(natives, "startswith", BOOL_T, strs, nativeStartsWith);
+	add(natives, "endswith", BOOL_T, strs, nativeEndsWith);
+	add(natives, "replace", STRING_T, std::vector<ParseDataType>(3, STRING_T), nativeReplace);
+
+	std::vector<ParseDataType> repeatArgs = str;
+	repeatArgs.push_back(INT32_T);
+	add(natives, "repeat", STRING_T, repeatArgs, nativeRepeat);
+	add(natives, "hash", UINT64_T, str, nativeHash);
+
+	return natives;
+}
+
+const std::vector<NativeFunction>& standardNativeFunctions() {
+	static const std::vector<NativeFunction> natives = makeStandardNativeFunctions();
+	return natives;
+}
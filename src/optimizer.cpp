@@ -0,0 +1,355 @@
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "statementnode.h"
+#include "function.h"
+#include "optimizer.h"
+#include "inliner.h"
+#include "tailcall.h"
+#include "cse.h"
+#include "strength.h"
+#include "bounds.h"
+#include "escape.h"
+#include "concat.h"
+#include "context.h"
+#include "program.h"
+
+OptimizerOptions defaultOptimizerOptions() {
+	OptimizerOptions options;
+	options.inlineFunctions = true;
+	options.inlineThreshold = 16;
+	return options;
+}
+
+void optimize(std::vector<AbstractStatementNode*>* statements, OptimizerOptions options) {
+
+	//recursive functions are never inlined, so the order of these two doesn't matter
+	markTailCalls(statements);
+
+	if(options.inlineFunctions)
+		inlineFunctionCalls(statements, options.inlineThreshold);
+
+	//string chains become single nodes before anything else looks at their operands
+	fuseConcatenations(statements);
+
+	//after inlining, so that inlined bodies are covered too
+	eliminateCommonSubexpressions(statements);
+
+	//rewrites the operators that are left with cheaper ones
+	reduceStrength(statements);
+
+	//last, so the accesses it rewrites are final
+	eliminateBoundsChecks(statements);
+
+	//looks at the final shape of every expression
+	markTemporaries(statements);
+}
+
+///////////////////////////////////
+///////     Traversal       ///////
+///////////////////////////////////
+
+std::vector<AbstractExpressionNode**> childExpressions(AbstractExpressionNode* node) {
+
+	std::vector<AbstractExpressionNode**> children;
+
+	if(AssignmentExpressionNode* n = dynamic_cast<AssignmentExpressionNode*>(node)) {
+		children.push_back(&n->value);
+
+	} else if(ArrayAssignmentExpressionNode* n = dynamic_cast<ArrayAssignmentExpressionNode*>(node)) {
+		//index is evaluated before the array
+		children.push_back(&n->index);
+		children.push_back(&n->array);
+		children.push_back(&n->value);
+
+	} else if(AbstractBinaryOperatorNode* n = dynamic_cast<AbstractBinaryOperatorNode*>(node)) {
+		children.push_back(&n->leftArg);
+		children.push_back(&n->rightArg);
+
+	} else if(UnaryOperatorNode* n = dynamic_cast<UnaryOperatorNode*>(node)) {
+		children.push_back(&n->leftArg);
+
+	} else if(CastNode* n = dynamic_cast<CastNode*>(node)) {
+		children.push_back(&n->expression);
+
+	} else if(ArrayAccessNode* n = dynamic_cast<ArrayAccessNode*>(node)) {
+		children.push_back(&n->array);
+		children.push_back(&n->start);
+		if(n->isSlice)
+			children.push_back(&n->end);
+
+	} else if(UncheckedArrayAccessNode* n = dynamic_cast<UncheckedArrayAccessNode*>(node)) {
+		children.push_back(&n->access->array);
+		children.push_back(&n->access->start);
+
+	} else if(ArrayNode* n = dynamic_cast<ArrayNode*>(node)) {
+		children.push_back(&n->length);
+
+		//initialized arrays always carry a literal length
+		if(n->isInitialized) {
+			uint32_t length = (uint32_t) dynamic_cast<LiteralNode*>(n->length)->data.value.integer;
+			for(uint32_t i = 0; i < length; i++)
+				children.push_back(&n->values[i]);
+		}
+
+	} else if(FunctionExpressionNode* n = dynamic_cast<FunctionExpressionNode*>(node)) {
+		for(uint32_t i = 0; i < n->numArgs; i++)
+			children.push_back(&n->arguments[i]);
+
+	} else if(InlinedFunctionNode* n = dynamic_cast<InlinedFunctionNode*>(node)) {
+		for(uint32_t i = 0; i < n->numArgs; i++)
+			children.push_back(&n->arguments[i]);
+		children.push_back(&n->body);
+
+	} else if(NativeFunctionNode* n = dynamic_cast<NativeFunctionNode*>(node)) {
+		for(uint32_t i = 0; i < n->numArgs; i++)
+			children.push_back(&n->arguments[i]);
+
+	} else if(GroupedExpressionNode* n = dynamic_cast<GroupedExpressionNode*>(node)) {
+		children.push_back(&n->closedExpression);
+
+	} else if(ConcatenationNode* n = dynamic_cast<ConcatenationNode*>(node)) {
+		for(uint32_t i = 0; i < n->numOperands; i++)
+			children.push_back(&n->operands[i]);
+
+	} else if(IntegerPowerNode* n = dynamic_cast<IntegerPowerNode*>(node)) {
+		children.push_back(&n->base);
+
+	} else if(ConstantDivisionNode* n = dynamic_cast<ConstantDivisionNode*>(node)) {
+		children.push_back(&n->dividend);
+
+	} else if(CommonSubexpressionNode* n = dynamic_cast<CommonSubexpressionNode*>(node)) {
+		//readers never evaluate the shared expression
+		if(n->isProducer)
+			children.push_back(&n->expression);
+	}
+
+	return children;
+}
+
+std::vector<AbstractExpressionNode**> childExpressions(AbstractStatementNode* node) {
+
+	std::vector<AbstractExpressionNode**> children;
+
+	if(ExpressionStatementNode* n = dynamic_cast<ExpressionStatementNode*>(node)) {
+		children.push_back(&n->expression);
+
+	} else if(PrintStatementNode* n = dynamic_cast<PrintStatementNode*>(node)) {
+		children.push_back(&n->expression);
+
+	} else if(PrintLineStatementNode* n = dynamic_cast<PrintLineStatementNode*>(node)) {
+		children.push_back(&n->expression);
+
+	} else if(PrintFormattedStatementNode* n = dynamic_cast<PrintFormattedStatementNode*>(node)) {
+		for(uint32_t i = 0; i < n->numArgs; i++)
+			children.push_back(&n->arguments[i]);
+
+	} else if(ConditionalStatementNode* n = dynamic_cast<ConditionalStatementNode*>(node)) {
+		for(uint32_t i = 0; i < n->conditions->size(); i++)
+			children.push_back(&(*n->conditions)[i]);
+
+	} else if(WhileStatementNode* n = dynamic_cast<WhileStatementNode*>(node)) {
+		children.push_back(&n->condition);
+
+	} else if(ForStatementNode* n = dynamic_cast<ForStatementNode*>(node)) {
+		children.push_back(&n->condition);
+
+	} else if(BenchStatementNode* n = dynamic_cast<BenchStatementNode*>(node)) {
+		if(n->runs != NULL)
+			children.push_back(&n->runs);
+
+	} else if(NewAssignmentStatementNode* n = dynamic_cast<NewAssignmentStatementNode*>(node)) {
+		if(n->value != NULL)
+			children.push_back(&n->value);
+
+	} else if(AssignmentStatementNode* n = dynamic_cast<AssignmentStatementNode*>(node)) {
+		children.push_back(&n->value);
+
+	} else if(ArrayAssignmentStatementNode* n = dynamic_cast<ArrayAssignmentStatementNode*>(node)) {
+		children.push_back(&n->index);
+		children.push_back(&n->value);
+
+	} else if(ReturnStatementNode* n = dynamic_cast<ReturnStatementNode*>(node)) {
+		children.push_back(&n->expression);
+	}
+
+	return children;
+}
+
+std::vector<AbstractStatementNode*> childStatements(AbstractStatementNode* node) {
+
+	std::vector<AbstractStatementNode*> children;
+
+	if(GroupedStatementNode* n = dynamic_cast<GroupedStatementNode*>(node)) {
+		children = *(n->statements);
+
+	} else if(ConditionalStatementNode* n = dynamic_cast<ConditionalStatementNode*>(node)) {
+		children = *(n->statements);
+
+	} else if(WhileStatementNode* n = dynamic_cast<WhileStatementNode*>(node)) {
+		children.push_back(n->body);
+
+	} else if(ForStatementNode* n = dynamic_cast<ForStatementNode*>(node)) {
+		children.push_back(n->initialization);
+		children.push_back(n->body);
+		children.push_back(n->update);
+
+	} else if(BenchStatementNode* n = dynamic_cast<BenchStatementNode*>(node)) {
+		children.push_back(n->body);
+
+	} else if(FunctionStatementNode* n = dynamic_cast<FunctionStatementNode*>(node)) {
+		if(n->function != NULL)
+			children = *(n->function->body);
+	}
+
+	return children;
+}
+
+uint32_t expressionSize(AbstractExpressionNode* node) {
+
+	uint32_t size = 1;
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+
+	for(uint32_t i = 0; i < children.size(); i++)
+		size += expressionSize(*children[i]);
+
+	return size;
+}
+
+//returns the literal's value if the node is a non-negative int literal, -1 otherwise
+int64_t intLiteralValue(AbstractExpressionNode* node) {
+
+	LiteralNode* literal = dynamic_cast<LiteralNode*>(node);
+	if(literal == NULL || literal->data.type != INT32_T)
+		return -1;
+
+	int32_t value = (int32_t) literal->data.value.integer;
+	return (value < 0) ? -1 : value;
+}
+
+//returns how much each update adds to the loop variable, or 0 if it isn't a simple step
+int64_t loopStep(AbstractStatementNode* update, std::string variable) {
+
+	AbstractExpressionNode* value = NULL;
+
+	if(ExpressionStatementNode* n = dynamic_cast<ExpressionStatementNode*>(update)) {
+
+		//i++ and i--
+		if(UnaryOperatorNode* unary = dynamic_cast<UnaryOperatorNode*>(n->expression)) {
+			VariableNode* var = dynamic_cast<VariableNode*>(unary->leftArg);
+			if(var == NULL || var->variable != variable)
+				return 0;
+
+			ParseOperatorType op = unary->operation;
+			return (op == POSTFIX_INC_OP || op == PREFIX_INC_OP) ? 1 :
+						 (op == POSTFIX_DEC_OP || op == PREFIX_DEC_OP) ? -1 : 0;
+		}
+
+		//i += k as an expression
+		AssignmentExpressionNode* assignment = dynamic_cast<AssignmentExpressionNode*>(n->expression);
+		if(assignment == NULL || assignment->variable != variable)
+			return 0;
+		value = assignment->value;
+
+	} else if(AssignmentStatementNode* n = dynamic_cast<AssignmentStatementNode*>(update)) {
+		if(n->variable != variable)
+			return 0;
+		value = n->value;
+	}
+
+	//i = i + k and i = i - k
+	ArithmeticOperatorNode* op = dynamic_cast<ArithmeticOperatorNode*>(value);
+	if(op == NULL || (op->operation != ADD_OP && op->operation != SUBTRACT_OP))
+		return 0;
+
+	VariableNode* var = dynamic_cast<VariableNode*>(op->leftArg);
+	int64_t constant = intLiteralValue(op->rightArg);
+	if(var == NULL || var->variable != variable || constant <= 0)
+		return 0;
+
+	return (op->operation == ADD_OP) ? constant : -constant;
+}
+
+///////////////////////////////////
+///////       Cloning       ///////
+///////////////////////////////////
+
+//parameters of inlined calls inside the cloned tree get fresh storage, so keep track of the mapping
+static AbstractExpressionNode* cloneHelper(AbstractExpressionNode* node, std::unordered_map<uint32_t, uint32_t>& parameterMap) {
+
+	AbstractExpressionNode* copy;
+
+	if(AssignmentExpressionNode* n = dynamic_cast<AssignmentExpressionNode*>(node)) {
+		copy = new AssignmentExpressionNode(*n);
+	} else if(ArrayAssignmentExpressionNode* n = dynamic_cast<ArrayAssignmentExpressionNode*>(node)) {
+		copy = new ArrayAssignmentExpressionNode(*n);
+	} else if(ArithmeticOperatorNode* n = dynamic_cast<ArithmeticOperatorNode*>(node)) {
+		copy = new ArithmeticOperatorNode(*n);
+	} else if(BitLogicalOperatorNode* n = dynamic_cast<BitLogicalOperatorNode*>(node)) {
+		copy = new BitLogicalOperatorNode(*n);
+	} else if(ComparisonOperatorNode* n = dynamic_cast<ComparisonOperatorNode*>(node)) {
+		copy = new ComparisonOperatorNode(*n);
+	} else if(UnaryOperatorNode* n = dynamic_cast<UnaryOperatorNode*>(node)) {
+		copy = new UnaryOperatorNode(*n);
+	} else if(CastNode* n = dynamic_cast<CastNode*>(node)) {
+		copy = new CastNode(*n);
+	} else if(ArrayAccessNode* n = dynamic_cast<ArrayAccessNode*>(node)) {
+		copy = new ArrayAccessNode(*n);
+	} else if(ArrayNode* n = dynamic_cast<ArrayNode*>(node)) {
+		ArrayNode* arrayCopy = new ArrayNode(*n);
+		if(n->isInitialized) {
+			uint32_t length = (uint32_t) dynamic_cast<LiteralNode*>(n->length)->data.value.integer;
+			arrayCopy->values = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * length);
+			memcpy(arrayCopy->values, n->values, sizeof(AbstractExpressionNode*) * length);
+		}
+		copy = arrayCopy;
+	} else if(VariableNode* n = dynamic_cast<VariableNode*>(node)) {
+		copy = new VariableNode(*n);
+	} else if(FunctionExpressionNode* n = dynamic_cast<FunctionExpressionNode*>(node)) {
+		FunctionExpressionNode* callCopy = new FunctionExpressionNode(*n);
+		callCopy->arguments = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * n->numArgs);
+		memcpy(callCopy->arguments, n->arguments, sizeof(AbstractExpressionNode*) * n->numArgs);
+		copy = callCopy;
+	} else if(InlinedFunctionNode* n = dynamic_cast<InlinedFunctionNode*>(node)) {
+		InlinedFunctionNode* callCopy = new InlinedFunctionNode(*n);
+		callCopy->arguments = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * n->numArgs);
+		memcpy(callCopy->arguments, n->arguments, sizeof(AbstractExpressionNode*) * n->numArgs);
+		callCopy->parameters = reserveSlots(n->numArgs);
+		for(uint32_t i = 0; i < n->numArgs; i++)
+			parameterMap[n->parameters + i] = callCopy->parameters + i;
+		copy = callCopy;
+	} else if(NativeFunctionNode* n = dynamic_cast<NativeFunctionNode*>(node)) {
+		NativeFunctionNode* callCopy = new NativeFunctionNode(*n);
+		callCopy->arguments = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * n->numArgs);
+		memcpy(callCopy->arguments, n->arguments, sizeof(AbstractExpressionNode*) * n->numArgs);
+		copy = callCopy;
+	} else if(ParameterNode* n = dynamic_cast<ParameterNode*>(node)) {
+		ParameterNode* parameterCopy = new ParameterNode(*n);
+		if(parameterMap.find(n->parameter) != parameterMap.end())
+			parameterCopy->parameter = parameterMap[n->parameter];
+		copy = parameterCopy;
+	} else if(LiteralNode* n = dynamic_cast<LiteralNode*>(node)) {
+		copy = new LiteralNode(*n);
+	} else if(BuiltinFunctionNode* n = dynamic_cast<BuiltinFunctionNode*>(node)) {
+		copy = new BuiltinFunctionNode(*n);
+	} else if(GroupedExpressionNode* n = dynamic_cast<GroupedExpressionNode*>(node)) {
+		copy = new GroupedExpressionNode(*n);
+	} else {
+		return node;
+	}
+
+	//children of the copy still point at the original subtrees
+	std::vector<AbstractExpressionNode**> children = childExpressions(copy);
+	for(uint32_t i = 0; i < children.size(); i++)
+		*children[i] = cloneHelper(*children[i], parameterMap);
+
+	return copy;
+}
+
+AbstractExpressionNode* cloneExpression(AbstractExpressionNode* node) {
+	std::unordered_map<uint32_t, uint32_t> parameterMap;
+	return cloneHelper(node, parameterMap);
+}
@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include "parsetoken.h"
+#include "array.h"
+#include "numconv.h"
+#include "output.h"
+
+#define OUTPUT_BUFFER_SIZE 65536
+
+//every thread prints through its own buffer
+static thread_local char buffer[OUTPUT_BUFFER_SIZE];
+static thread_local size_t used = 0;
+static thread_local std::string* capture = NULL;
+static bool flushEveryPrint = false;
+
+void setLineBuffered(bool lineBuffered) {
+	flushEveryPrint = lineBuffered;
+}
+
+std::string* captureOutput(std::string* into) {
+	std::string* previous = capture;
+	capture = into;
+	return previous;
+}
+
+static void writeAll(const char* str, size_t length) {
+
+	if(capture != NULL) {
+		capture->append(str, length);
+		return;
+	}
+
+	while(length > 0) {
+		ssize_t written = write(STDOUT_FILENO, str, length);
+		if(written <= 0)
+			return;
+
+		str += written;
+		length -= written;
+	}
+}
+
+void flushOutput() {
+	writeAll(buffer, used);
+	used = 0;
+}
+
+void writeOutput(const char* str, size_t length) {
+
+	if(used + length > OUTPUT_BUFFER_SIZE)
+		flushOutput();
+
+	//too big to be worth copying
+	if(length > OUTPUT_BUFFER_SIZE) {
+		writeAll(str, length);
+		return;
+	}
+
+	memcpy(buffer + used, str, length);
+	used += length;
+}
+
+//makes sure a number can be formatted in place
+static char* reserve(size_t length) {
+
+	if(used + length > OUTPUT_BUFFER_SIZE)
+		flushOutput();
+
+	return buffer + used;
+}
+
+//numbers are formatted straight into the buffer
+static void writeSigned(int64_t value) {
+	char* out = reserve(MAX_NUMBER_LENGTH);
+	used += formatSigned(value, out);
+}
+
+static void writeUnsigned(uint64_t value) {
+	char* out = reserve(MAX_NUMBER_LENGTH);
+	used += formatUnsigned(value, out);
+}
+
+static void writeDouble(double value) {
+	char* out = reserve(MAX_NUMBER_LENGTH);
+	used += formatDouble(value, out);
+}
+
+void writeValue(ParseData d) {
+
+	switch(d.type) {
+
+		case INT8_T: writeSigned((int8_t) d.value.integer); break;
+		case INT16_T: writeSigned((int16_t) d.value.integer); break;
+		case INT32_T: writeSigned((int32_t) d.value.integer); break;
+		case INT64_T: writeSigned((int64_t) d.value.integer); break;
+
+		case UINT8_T: writeUnsigned((uint8_t) d.value.integer); break;
+		case UINT16_T: writeUnsigned((uint16_t) d.value.integer); break;
+		case UINT32_T: writeUnsigned((uint32_t) d.value.integer); break;
+		case UINT64_T: writeUnsigned((uint64_t) d.value.integer); break;
+
+		//a null char ends the string it would have been printed as
+		case CHAR_T: {
+			char c = (char) ((uint8_t) d.value.integer);
+			if(c != '\0')
+				writeOutput(&c, 1);
+			break;
+		}
+
+		case DOUBLE_T: writeDouble((double) d.value.floatingPoint); break;
+
+		case BOOL_T: {
+			if(d.value.integer)
+				writeOutput("true", 4);
+			else
+				writeOutput("false", 5);
+			break;
+		}
+
+		case STRING_T: {
+			char* str = (char*) d.value.allocated;
+			writeOutput(str, strlen(str));
+			break;
+		}
+
+		case ARRAY_T: {
+			Array* arr = (Array*) d.value.allocated;
+
+			writeOutput("[", 1);
+			for(uint32_t i = 0; i < arr->length; i++) {
+				if(i > 0)
+					writeOutput(", ", 2);
+				writeValue(arr->values[i]);
+			}
+			writeOutput("]", 1);
+			break;
+		}
+
+		case VOID_T: writeOutput("VOID", 4); break;
+		default: writeOutput("INVALID", 7); break;
+	}
+}
+
+void endPrint() {
+	if(flushEveryPrint)
+		flushOutput();
+}
+
+void printValue(ParseData d, bool newline) {
+
+	writeValue(d);
+	if(newline)
+		writeOutput("\n", 1);
+
+	endPrint();
+}
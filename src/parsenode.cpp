@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <string>
 #include <algorithm>
 #include <iostream>
@@ -6,9 +7,28 @@
 #include "typehandler.h"
 #include "evaluator.h"
 #include "symboltable.h"
+#include "context.h"
 #include "function.h"
 #include "array.h"
 #include "parsenode.h"
+#include "counters.h"
+#include "program.h"
+
+AbstractExpressionNode::AbstractExpressionNode() {
+  if(compilingProgram != NULL)
+    compilingProgram->expressionNodes.push_back(this);
+}
+
+AbstractExpressionNode::AbstractExpressionNode(const AbstractExpressionNode& node) {
+
+  startLine = node.startLine;
+  endLine = node.endLine;
+  evalType = node.evalType;
+  subType = node.subType;
+
+  if(compilingProgram != NULL)
+    compilingProgram->expressionNodes.push_back(this);
+}
 
 ///////////////////////////////////
 ///////     Assignment      ///////
@@ -31,6 +51,7 @@ AssignmentExpressionNode::AssignmentExpressionNode(std::string var, ParseDataTyp
 }
 
 ParseData AssignmentExpressionNode::evaluate() {
+  COUNT_NODE("AssignmentExpressionNode");
   return evaluateAssignmentExpression(this);
 }
 
@@ -51,6 +72,7 @@ ArrayAssignmentExpressionNode::ArrayAssignmentExpressionNode(AbstractExpressionN
 }
 
 ParseData ArrayAssignmentExpressionNode::evaluate() {
+	COUNT_NODE("ArrayAssignmentExpressionNode");
 	return evaluateArrayAssignmentExpression(this);
 }
 
@@ -82,6 +104,7 @@ UnaryOperatorNode::UnaryOperatorNode(ParseOperatorType op, AbstractExpressionNod
 }
 
 ParseData UnaryOperatorNode::evaluate() {
+  COUNT_NODE("UnaryOperatorNode");
   return evaluateUnaryExpression(this);
 }
 
@@ -115,12 +138,114 @@ ArithmeticOperatorNode::ArithmeticOperatorNode(ParseOperatorType op, AbstractExp
   endLine = r->endLine;
   evalType = getTypeArithmeticExpression(op, l->evalType, r->evalType);
 	subType = (evalType == STRING_T) ? CHAR_T : INVALID_T;
+  isTemporary = false;
 }
 
 ParseData ArithmeticOperatorNode::evaluate() { 
+  COUNT_NODE("ArithmeticOperatorNode");
   return evaluateArithmeticExpression(this);
 }
 
+//string concatenation chain
+ConcatenationNode::ConcatenationNode(AbstractExpressionNode* exp, AbstractExpressionNode** ops, uint32_t num) {
+  expression = exp;
+  operands = ops;
+  numOperands = num;
+  isTemporary = false;
+  startLine = exp->startLine;
+  endLine = exp->endLine;
+  evalType = exp->evalType;
+  subType = exp->subType;
+}
+
+ParseData ConcatenationNode::evaluate() {
+  COUNT_NODE("ConcatenationNode");
+  return evaluateConcatenationExpression(this);
+}
+
+std::string ConcatenationNode::toString() {
+  return expression->toString();
+}
+
+//constant integer power
+IntegerPowerNode::IntegerPowerNode(ArithmeticOperatorNode* power) {
+  base = power->leftArg;
+  exponent = ((LiteralNode*) power->rightArg)->data;
+  startLine = power->startLine;
+  endLine = power->endLine;
+  evalType = power->evalType;
+  subType = power->subType;
+}
+
+ParseData IntegerPowerNode::evaluate() {
+  COUNT_NODE("IntegerPowerNode");
+  return evaluateIntegerPowerExpression(this);
+}
+
+std::string IntegerPowerNode::toString() {
+  std::string str = "( ** ";
+  str.append(base->toString());
+  str.append(" ");
+  str.append(toStringParseData(exponent));
+  str.append(")");
+  return str;
+}
+
+//division by constant
+ConstantDivisionNode::ConstantDivisionNode(ArithmeticOperatorNode* division) {
+  operation = division->operation;
+  dividend = division->leftArg;
+  divisor = ((LiteralNode*) division->rightArg)->data;
+  startLine = division->startLine;
+  endLine = division->endLine;
+  evalType = division->evalType;
+  subType = division->subType;
+
+  uint64_t d = (uint32_t) divisor.value.integer;
+  isPowerOfTwo = (d & (d-1)) == 0;
+  shift = 0;
+  while(((uint64_t) 1 << shift) < d)
+    shift++;
+
+  //unused (and would overflow) for powers of two
+  multiplier = isPowerOfTwo ? 0 : UINT64_MAX / d + 1;
+}
+
+ParseData ConstantDivisionNode::evaluate() {
+  COUNT_NODE("ConstantDivisionNode");
+  return evaluateConstantDivisionExpression(this);
+}
+
+std::string ConstantDivisionNode::toString() {
+  std::string str = "( ";
+  str.append(toStringParseOperatorType(operation));
+  str.append(" ");
+  str.append(dividend->toString());
+  str.append(" ");
+  str.append(toStringParseData(divisor));
+  str.append(")");
+  return str;
+}
+
+//induction variable
+InductionVariableNode::InductionVariableNode(AbstractExpressionNode* prod, uint32_t val) {
+  product = prod;
+  value = val;
+  startLine = prod->startLine;
+  endLine = prod->endLine;
+  evalType = prod->evalType;
+  subType = prod->subType;
+}
+
+ParseData InductionVariableNode::evaluate() {
+  COUNT_NODE("InductionVariableNode");
+  return runningContext->slots[value];
+}
+
+std::string InductionVariableNode::toString() {
+  return product->toString();
+}
+
 //class that represents bitwise and logical operations
 BitLogicalOperatorNode::BitLogicalOperatorNode(ParseOperatorType op, AbstractExpressionNode* l, AbstractExpressionNode* r) {
   operation = op;
@@ -133,6 +258,7 @@ BitLogicalOperatorNode::BitLogicalOperatorNode(ParseOperatorType op, AbstractExp
 }
 
 ParseData BitLogicalOperatorNode::evaluate() { 
+  COUNT_NODE("BitLogicalOperatorNode");
   return evaluateBitLogicalExpression(this);
 }
 
@@ -149,6 +275,7 @@ ComparisonOperatorNode::ComparisonOperatorNode(ParseOperatorType op, AbstractExp
 }
 
 ParseData ComparisonOperatorNode::evaluate() { 
+  COUNT_NODE("ComparisonOperatorNode");
   return evaluateComparisonExpression(this);
 }
 
@@ -176,6 +303,7 @@ std::string CastNode::toString() {
 }
 
 ParseData CastNode::evaluate() {
+  COUNT_NODE("CastNode");
   return evaluateCastExpression(this);
 }
 
@@ -185,7 +313,7 @@ ParseData CastNode::evaluate() {
 ///////////////////////////////////
 
 ArrayAccessNode::ArrayAccessNode(AbstractExpressionNode* arr, AbstractExpressionNode* s, char* context, uint32_t endLin) {
-	array = arr; start = s; endLine = endLin; isSlice = false;
+	array = arr; start = s; endLine = endLin; isSlice = false; isTemporary = false;
 	startLine = arr->startLine;
 	endLine = endLin;
 	this->context = context;
@@ -194,7 +322,7 @@ ArrayAccessNode::ArrayAccessNode(AbstractExpressionNode* arr, AbstractExpression
 }
 
 ArrayAccessNode::ArrayAccessNode(AbstractExpressionNode* arr, AbstractExpressionNode* s, AbstractExpressionNode* e, char* context, uint32_t endLin) {
-  array = arr; start = s; end = e; endLine = endLin; isSlice = true;
+  array = arr; start = s; end = e; endLine = endLin; isSlice = true; isTemporary = false;
   startLine = arr->startLine;
   endLine = endLin;
 	this->context = context;
@@ -203,6 +331,7 @@ ArrayAccessNode::ArrayAccessNode(AbstractExpressionNode* arr, AbstractExpression
 }
 
 ParseData ArrayAccessNode::evaluate() {
+  COUNT_NODE("ArrayAccessNode");
   return evaluateArrayAccess(this);
 }
 
@@ -226,6 +355,25 @@ std::string ArrayAccessNode::toString() {
   return str;
 }
 
+//unchecked array access
+UncheckedArrayAccessNode::UncheckedArrayAccessNode(ArrayAccessNode* acc, uint32_t range) {
+  access = acc;
+  inRange = range;
+  startLine = acc->startLine;
+  endLine = acc->endLine;
+  evalType = acc->evalType;
+  subType = acc->subType;
+}
+
+ParseData UncheckedArrayAccessNode::evaluate() {
+  COUNT_NODE("UncheckedArrayAccessNode");
+  return evaluateUncheckedArrayAccess(this);
+}
+
+std::string UncheckedArrayAccessNode::toString() {
+  return access->toString();
+}
+
 ///////////////////////////////////
 ///////        Arrays       ///////
 ///////////////////////////////////
@@ -242,6 +390,7 @@ ArrayNode::ArrayNode(ParseDataType sType, bool isInit, AbstractExpressionNode* l
 }
 
 ParseData ArrayNode::evaluate() {
+	COUNT_NODE("ArrayNode");
 	return evaluateArrayExpression(this);
 }
 
@@ -270,7 +419,8 @@ VariableNode::VariableNode(std::string var, SymbolTable* table, uint32_t line) {
 }
 
 ParseData VariableNode::evaluate() {
-  return symbolTable->get(variable);
+  COUNT_NODE("VariableNode");
+  return runningContext->variables.get(variable);
 }
 
 std::string VariableNode::toString() {
@@ -290,14 +440,12 @@ FunctionExpressionNode::FunctionExpressionNode(uint32_t nArgs, AbstractExpressio
 	subType = (evalType == STRING_T) ? CHAR_T :
 						INVALID_T;
 
-	isReturned = f->returnFlag;
-	returnValue = f->returnValue;
-
   this->startLine = startLine;
   this->endLine = endLine;
 }
 
 ParseData FunctionExpressionNode::evaluate() {
+	COUNT_NODE("FunctionExpressionNode");
 	return evaluateFunctionExpression(this);
 }
 
@@ -306,6 +454,81 @@ std::string FunctionExpressionNode::toString() {
 	return str;
 }
 
+NativeFunctionNode::NativeFunctionNode(const NativeFunction* f, AbstractExpressionNode** args, char* con, uint32_t startLine, uint32_t endLine) {
+	numArgs = f->argTypes.size();
+	arguments = args;
+	function = f;
+	context = con;
+	isTemporary = false;
+	evalType = f->returnType;
+	subType = (evalType == STRING_T) ? CHAR_T :
+						INVALID_T;
+
+  this->startLine = startLine;
+  this->endLine = endLine;
+}
+
+ParseData NativeFunctionNode::evaluate() {
+	COUNT_NODE("NativeFunctionNode");
+	return evaluateNativeFunctionExpression(this);
+}
+
+std::string NativeFunctionNode::toString() {
+	std::string str = function->name;
+	str.append("(");
+	for(uint32_t i = 0; i < numArgs; i++) {
+		if(i > 0)
+			str.append(", ");
+		str.append(arguments[i]->toString());
+	}
+	str.append(")");
+	return str;
+}
+
+//inlined call
+InlinedFunctionNode::InlinedFunctionNode(FunctionExpressionNode* call, uint32_t params, AbstractExpressionNode* bod) {
+	numArgs = call->numArgs;
+	arguments = call->arguments;
+	function = call->function;
+	parameters = params;
+	body = bod;
+	evalType = call->evalType;
+	subType = call->subType;
+	startLine = call->startLine;
+	endLine = call->endLine;
+}
+
+ParseData InlinedFunctionNode::evaluate() {
+	COUNT_NODE("InlinedFunctionNode");
+	return evaluateInlinedFunctionExpression(this);
+}
+
+std::string InlinedFunctionNode::toString() {
+	std::string str = "(inline ";
+	str.append(body->toString());
+	str.append(")");
+	return str;
+}
+
+//parameter of inlined call
+ParameterNode::ParameterNode(VariableNode* var, uint32_t param) {
+	variable = var->variable;
+	parameter = param;
+	evalType = var->evalType;
+	subType = var->subType;
+	startLine = var->startLine;
+	endLine = var->endLine;
+}
+
+ParseData ParameterNode::evaluate() {
+	COUNT_NODE("ParameterNode");
+	return runningContext->slots[parameter];
+}
+
+std::string ParameterNode::toString() {
+	return std::string(variable);
+}
+
 
 ///////////////////////////////////
 ///////      Literal        ///////
@@ -321,6 +544,7 @@ LiteralNode::LiteralNode(ParseData d, uint32_t line) {
 }
 
 ParseData LiteralNode::evaluate() { 
+  COUNT_NODE("LiteralNode");
   return evaluateLiteralExpression(this);
 }
 
@@ -328,6 +552,25 @@ std::string LiteralNode::toString() {
   return std::string(toStringParseData(data));
 }
 
+BuiltinFunctionNode::BuiltinFunctionNode(BuiltinFunction f, uint32_t startLin, uint32_t endLin) {
+  function = f;
+  startLine = startLin;
+  endLine = endLin;
+  evalType = getTypeBuiltinFunctionExpression(f);
+  subType = INVALID_T;
+}
+
+ParseData BuiltinFunctionNode::evaluate() {
+  COUNT_NODE("BuiltinFunctionNode");
+  return evaluateBuiltinFunctionExpression(this);
+}
+
+std::string BuiltinFunctionNode::toString() {
+  std::string str(toStringBuiltinFunction(function));
+  str.append("()");
+  return str;
+}
+
 ///////////////////////////////////
 ///////      Grouped        ///////
 ///////////////////////////////////
@@ -343,6 +586,7 @@ GroupedExpressionNode::GroupedExpressionNode(AbstractExpressionNode* exp, uint32
 }
 
 ParseData GroupedExpressionNode::evaluate() { 
+  COUNT_NODE("GroupedExpressionNode");
   return evaluateGroupedExpression(this);
 }
 
@@ -351,4 +595,33 @@ std::string GroupedExpressionNode::toString() {
   str.append(closedExpression->toString());
   str.append(")");
   return str;
-}
\ No newline at end of file
+}
+
+///////////////////////////////////
+///////   Subexpression     ///////
+///////////////////////////////////
+
+CommonSubexpressionNode::CommonSubexpressionNode(AbstractExpressionNode* exp, uint32_t val, bool isProd) {
+  expression = exp;
+  value = val;
+  isProducer = isProd;
+  startLine = exp->startLine;
+  endLine = exp->endLine;
+  evalType = exp->evalType;
+  subType = exp->subType;
+}
+
+ParseData CommonSubexpressionNode::evaluate() {
+  COUNT_NODE("CommonSubexpressionNode");
+
+  //the producer always runs before any reader in the same block
+  ParseData* slot = &runningContext->slots[value];
+  if(isProducer)
+    *slot = expression->evaluate();
+
+  return *slot;
+}
+
+std::string CommonSubexpressionNode::toString() {
+  return expression->toString();
+}
@@ -12,47 +12,36 @@
 #include "parser.h"
 #include "function.h"
 #include "array.h"
+#include "format.h"
+#include "program.h"
+#include "native.h"
 
 using namespace std;
 
-static uint32_t tokenIndex;
-static vector<Token>* tokens;
-static SymbolTable* symbolTable;
-static vector<char*>* codeLines;
-
-//used by return statements to place value in correct memory location
-//and keep track of function type
-static vector<bool*> returnFlag;
-static vector<ParseData*> returnValue;
-static vector<ParseDataType> returnType;
-
-//some state variables
-static bool insideClassDefinition;
-
 /////////////////////////////////
 //////   Utility Functions  /////
 /////////////////////////////////
 
 //return current Token and advance
-Token* consume() {
+Token* Parser::consume() {
   return (Token*) &(tokens->at(tokenIndex++));
 }
 
-void stepBack() {
+void Parser::stepBack() {
 	tokenIndex--;
 }
 
 //examine the current Token, don't advance position
-Token* peek() {
+Token* Parser::peek() {
   return (Token*) &(tokens->at(tokenIndex));
 }
 
 //examine a Token at given index
-Token* peekAhead(uint32_t offset) {
+Token* Parser::peekAhead(uint32_t offset) {
   return (Token*) &(tokens->at(tokenIndex+offset));
 }
 
-char* getCodeLineBlock(uint32_t startIndex, uint32_t endIndex) {
+char* Parser::getCodeLineBlock(uint32_t startIndex, uint32_t endIndex) {
 
   //append all lines to a string object
   string str;
@@ -66,16 +55,11 @@ char* getCodeLineBlock(uint32_t startIndex, uint32_t endIndex) {
 }
 
 //used to parse function definition and return struct with information
-Function* parseFunction(uint32_t startLine, uint32_t secondStartLine, string functionName) {
+Function* Parser::parseFunction(uint32_t startLine, uint32_t secondStartLine, string functionName) {
 
 	//now create a Function struct
-	Function* function = (Function*) malloc(sizeof(Function));
-	function->returnFlag = (bool*) malloc(sizeof(bool));
-	function->returnValue = (ParseData*) malloc(sizeof(ParseData));
-
-	//assign the global returnFlag and returnValue pointers to this function
-	returnFlag.push_back(function->returnFlag);
-	returnValue.push_back(function->returnValue);
+	Function* function = (Function*) allocateProgram(sizeof(Function));
+	function->name = copyString(functionName.c_str());
 
 	//now read in arguments enclosed in parentheses
 	Token* leftParenToken = consume(); //consume (
@@ -172,9 +156,9 @@ Function* parseFunction(uint32_t startLine, uint32_t secondStartLine, string fun
 
 	//now allocate memory for argument names and types
 	function->numArgs = argCount;
-	ParseDataType* argTypes = new ParseDataType[argCount];
-	ParseDataType* argSubTypes = new ParseDataType[argCount];
-	char** argNames = (char**) malloc(sizeof(char*) * argCount);
+	ParseDataType* argTypes = (ParseDataType*) allocateProgram(sizeof(ParseDataType) * argCount);
+	ParseDataType* argSubTypes = (ParseDataType*) allocateProgram(sizeof(ParseDataType) * argCount);
+	char** argNames = (char**) allocateProgram(sizeof(char*) * argCount);
 
 	//keep track of variable line numbers
 	uint32_t typeLines[argCount];
@@ -281,7 +265,7 @@ Function* parseFunction(uint32_t startLine, uint32_t secondStartLine, string fun
 	}
 
 	//represents statements in body
-	vector<AbstractStatementNode*>* body = new vector<AbstractStatementNode*>();
+	vector<AbstractStatementNode*>* body = newStatementList();
 
 	while(peek()->type != RIGHT_BRACE) {
 		body->push_back(addStatement());  
@@ -293,19 +277,89 @@ Function* parseFunction(uint32_t startLine, uint32_t secondStartLine, string fun
 	function->body = body;
 
 	//reset global pointers
-	returnFlag.pop_back();
-	returnValue.pop_back();
 	returnType.pop_back();
 
 	return function;
 }
 
+//reads and typechecks the arguments of a call to a function with these types, up to and including the )
+Token* Parser::parseArguments(Token* variable, Token* leftParenToken, uint32_t numArgs, ParseDataType* argTypes, ParseDataType* argSubTypes,
+															AbstractExpressionNode** arguments) {
+
+	Token* lastCommaToken = leftParenToken;
+
+	for(uint32_t i = 0; i < numArgs; i++) {
+
+		//if next item is not an argument, throw error
+		if(peek()->type == END) {
+			uint32_t startLine = variable->line+1;
+			uint32_t endLine = (i > 0) ? arguments[i-1]->endLine : leftParenToken->line+1;
+			throw ParseSyntaxError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), "Too few arguments provided to this function call");
+		}
+
+		//get next argument
+		arguments[i] = evalExpression();
+
+		//make sure argument is of the right type
+		if(argTypes[i] == ARRAY_T && arguments[i]->evalType == ARRAY_T) {
+
+			//both args are arrays, so check member types
+			if(!typecheckImplicitCastExpression(arguments[i]->subType, argSubTypes[i])) {
+				
+				uint32_t startLine = variable->line+1;
+				uint32_t endLine = arguments[i]->endLine;
+
+				string message = "Cannot implicitly convert a ";
+				message.append(toStringParseDataType(arguments[i]->subType));
+				message.append(" array argument to ");
+				message.append(toStringParseDataType(argSubTypes[i]));
+				message.append(" array type");
+
+				throw StaticTypeError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), copyString(message.c_str()));
+			}
+
+		} else {
+
+			//regular type check
+			if(!typecheckImplicitCastExpression(arguments[i]->evalType, argTypes[i])) {
+
+				uint32_t startLine = variable->line+1;
+				uint32_t endLine = arguments[i]->endLine;
+
+				string message = "Cannot implicitly convert a ";
+				message.append(toStringParseDataType(arguments[i]->evalType));
+				message.append(" argument to ");
+				message.append(toStringParseDataType(argTypes[i]));
+				message.append(" type");
+
+				throw StaticTypeError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), copyString(message.c_str()));
+			}
+		}
+
+		if(i < numArgs-1) {
+			if(peek()->type != COMMA) {
+				throw ParseSyntaxError(variable->line+1, arguments[i]->endLine, getCodeLineBlock(variable->line, arguments[i]->endLine-1),
+															"Expected comma to separate function arguments");
+			}
+			lastCommaToken = consume(); //consume ,
+		}
+	}
+
+	if(peek()->type != RIGHT_PAREN) {
+		throw ParseSyntaxError(variable->line+1, lastCommaToken->line+1, getCodeLineBlock(variable->line, lastCommaToken->line),
+													"Expected ')' to terminate argument list");
+	}
+	Token* rightParenToken = consume(); //consume )
+
+	return rightParenToken;
+}
+
 /////////////////////////////////
 //////    Subroutines     ///////
 /////////////////////////////////
 
 // variable, number, string, etc.
-AbstractExpressionNode* evalLiteralGroup() {
+AbstractExpressionNode* Parser::evalLiteralGroup() {
 
   AbstractExpressionNode* next;
  
@@ -365,7 +419,7 @@ AbstractExpressionNode* evalLiteralGroup() {
 		Token* rightBracketToken = consume(); //consume ']'
 
 		uint32_t length = (uint32_t) initValues.size();
-		AbstractExpressionNode** values = (AbstractExpressionNode**) malloc(sizeof(AbstractExpressionNode*) * length);
+		AbstractExpressionNode** values = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * length);
 
 		//determine overall type of initialized array
 		ParseDataType arrayType = arrayListType(&initValues);
@@ -425,9 +479,54 @@ AbstractExpressionNode* evalLiteralGroup() {
   } else if(peek()->type == VARIABLE) {
 
 		Token* variable = consume();
+		string variableName((char*) variable->lexeme);
+
+		//built-in functions are called by names the program hasn't declared itself
+		BuiltinFunction builtin = nameBuiltinConversion(variable->lexeme);
+		if(builtin != INVALID_FUN && peek()->type == LEFT_PAREN && !symbolTable->isDeclared(variableName)) {
+
+			Token* leftParenToken = consume(); //consume (
+			if(peek()->type != RIGHT_PAREN) {
+				throw ParseSyntaxError(variable->line+1, leftParenToken->line+1, getCodeLineBlock(variable->line, leftParenToken->line),
+															"Expected ')', this built-in function takes no arguments");
+			}
+			Token* rightParenToken = consume(); //consume )
+
+			return new BuiltinFunctionNode(builtin, variable->line+1, rightParenToken->line+1);
+		}
+
+		//so are native functions, they're typechecked like the program's own
+		const NativeFunction* native = NULL;
+		if(peek()->type == LEFT_PAREN && !symbolTable->isDeclared(variableName))
+			native = findNativeFunction(variableName);
+
+		if(native != NULL) {
+
+			Token* leftParenToken = consume(); //consume (
+			uint32_t numArgs = native->argTypes.size();
+			ParseDataType* argTypes = (ParseDataType*) native->argTypes.data();
+
+			AbstractExpressionNode** arguments = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * numArgs);
+			Token* rightParenToken = parseArguments(variable, leftParenToken, numArgs, argTypes, NULL, arguments);
+
+			//the program's functions take any value as a string, natives only primitives
+			for(uint32_t i = 0; i < numArgs; i++) {
+				if(!isNativeParseDataType(arguments[i]->evalType, false)) {
+
+					string message = "Cannot implicitly convert a ";
+					message.append(toStringParseDataType(arguments[i]->evalType));
+					message.append(" argument to ");
+					message.append(toStringParseDataType(argTypes[i]));
+					message.append(" type");
+
+					throw StaticTypeError(variable->line+1, arguments[i]->endLine, getCodeLineBlock(variable->line, arguments[i]->endLine-1), copyString(message.c_str()));
+				}
+			}
+
+			return new NativeFunctionNode(native, arguments, getCodeLineBlock(variable->line, rightParenToken->line), variable->line+1, rightParenToken->line+1);
+		}
 
 		//make sure variable is already declared
-		string variableName((char*) variable->lexeme);
 		if(!symbolTable->isDeclared(variableName)) {
 			throw StaticVariableScopeError(variable->line+1, variable->lexeme, getCodeLineBlock(variable->line, variable->line), false);
 		}
@@ -447,77 +546,10 @@ AbstractExpressionNode* evalLiteralGroup() {
 			
 			//get function information
 			Function* function = (Function*) (symbolTable->get(variableName).value.allocated);
-
 			uint32_t numArgs = function->numArgs;
-			ParseDataType* argTypes = function->argTypes;
-			ParseDataType* argSubTypes = function->argSubTypes;
-
-			//read in arguments
-			AbstractExpressionNode** arguments = (AbstractExpressionNode**) malloc(sizeof(AbstractExpressionNode*) * numArgs);
-			Token* lastCommaToken;
-
-			for(uint32_t i = 0; i < numArgs; i++) {
-
-				//if next item is not an argument, throw error
-				if(peek()->type == END) {
-					uint32_t startLine = variable->line+1;
-					uint32_t endLine = (i > 0) ? arguments[i-1]->endLine+1 : leftParenToken->line+1;
-					throw ParseSyntaxError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), "Too few arguments provided to this function call");
-				}
-
-				//get next argument
-				arguments[i] = evalExpression();
-
-				//make sure argument is of the right type
-				if(argTypes[i] == ARRAY_T && arguments[i]->evalType == ARRAY_T) {
-
-					//both args are arrays, so check member types
-					if(!typecheckImplicitCastExpression(arguments[i]->subType, argSubTypes[i])) {
-						
-						uint32_t startLine = variable->line+1;
-						uint32_t endLine = arguments[i]->endLine+1;
-
-						string message = "Cannot implicitly convert a ";
-						message.append(toStringParseDataType(arguments[i]->subType));
-						message.append(" array argument to ");
-						message.append(toStringParseDataType(argSubTypes[i]));
-						message.append(" array type");
-
-						throw StaticTypeError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), copyString(message.c_str()));
-					}
-
-				} else {
-
-					//regular type check
-					if(!typecheckImplicitCastExpression(arguments[i]->evalType, argTypes[i])) {
 
-						uint32_t startLine = variable->line+1;
-						uint32_t endLine = arguments[i]->endLine+1;
-
-						string message = "Cannot implicitly convert a ";
-						message.append(toStringParseDataType(arguments[i]->evalType));
-						message.append(" argument to ");
-						message.append(toStringParseDataType(argTypes[i]));
-						message.append(" type");
-
-						throw StaticTypeError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), copyString(message.c_str()));
-					}
-				}
-
-				if(i < numArgs-1) {
-					if(peek()->type != COMMA) {
-						throw ParseSyntaxError(variable->line+1, arguments[i]->endLine+1, getCodeLineBlock(variable->line, arguments[i]->endLine),
-																	"Expected comma to separate function arguments");
-					}
-					lastCommaToken = consume(); //consume ,
-				}
-			}
-
-			if(peek()->type != RIGHT_PAREN) {
-				throw ParseSyntaxError(variable->line+1, lastCommaToken->line+1, getCodeLineBlock(variable->line, lastCommaToken->line),
-															"Expected ')' to terminate argument list");
-			}
-			Token* rightParenToken = consume(); //consume )
+			AbstractExpressionNode** arguments = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * numArgs);
+			Token* rightParenToken = parseArguments(variable, leftParenToken, numArgs, function->argTypes, function->argSubTypes, arguments);
 
 			//now return FunctionExpressionNode
 			return new FunctionExpressionNode(numArgs, arguments, function, symbolTable, variable->line+1, rightParenToken->line+1);
@@ -537,11 +569,11 @@ AbstractExpressionNode* evalLiteralGroup() {
 }
 
 //member access (strings and arrays)
-bool isPostfixStructure() {
+bool Parser::isPostfixStructure() {
   return (peek()->type == ADD && peekAhead(1)->type == ADD) || (peek()->type == SUBTRACT && peekAhead(1)->type == SUBTRACT);
 }
 
-AbstractExpressionNode* handleMemberAccess(AbstractExpressionNode* head) {
+AbstractExpressionNode* Parser::handleMemberAccess(AbstractExpressionNode* head) {
 
   if(head->evalType != STRING_T && head->evalType != ARRAY_T) {
       
@@ -659,7 +691,7 @@ AbstractExpressionNode* handleMemberAccess(AbstractExpressionNode* head) {
   return NULL;
 }
 
-AbstractExpressionNode* evalPostfixMemberAccess() {
+AbstractExpressionNode* Parser::evalPostfixMemberAccess() {
   
   AbstractExpressionNode* head = evalLiteralGroup();
   VariableNode* varNode = dynamic_cast<VariableNode*>(head);
@@ -703,16 +735,16 @@ AbstractExpressionNode* evalPostfixMemberAccess() {
 }
 
 
-bool isCastStructure() {
+bool Parser::isCastStructure() {
   return peek()->type == LEFT_PAREN && isTypeTokenType(peekAhead(1)->type) && peekAhead(2)->type == RIGHT_PAREN;
 }
 
-bool isPrefixStructure() {
+bool Parser::isPrefixStructure() {
   return (peek()->type == ADD && peekAhead(1)->type == ADD) || (peek()->type == SUBTRACT && peekAhead(1)->type == SUBTRACT);
 }
 
 //sign and bit/logical NOT
-AbstractExpressionNode* evalPrefixCastSignNot() {
+AbstractExpressionNode* Parser::evalPrefixCastSignNot() {
  
   //check if prefix
   if(isPrefixStructure()) {
@@ -786,7 +818,7 @@ AbstractExpressionNode* evalPrefixCastSignNot() {
 
 
 // **
-AbstractExpressionNode* evalExponent() {
+AbstractExpressionNode* Parser::evalExponent() {
 
   AbstractExpressionNode* head = evalPrefixCastSignNot();
   AbstractExpressionNode* next;
@@ -808,7 +840,7 @@ AbstractExpressionNode* evalExponent() {
 
 
 // * / %
-AbstractExpressionNode* evalMultiplyDivideMod() {
+AbstractExpressionNode* Parser::evalMultiplyDivideMod() {
 
   AbstractExpressionNode* head = evalExponent();
   AbstractExpressionNode* next;
@@ -831,7 +863,7 @@ AbstractExpressionNode* evalMultiplyDivideMod() {
 
 
 // + -
-AbstractExpressionNode* evalAddSubtract() {
+AbstractExpressionNode* Parser::evalAddSubtract() {
 
   AbstractExpressionNode* head = evalMultiplyDivideMod();
   AbstractExpressionNode* next;
@@ -851,7 +883,7 @@ AbstractExpressionNode* evalAddSubtract() {
 }
 
 // << >>
-AbstractExpressionNode* evalBitShift() {
+AbstractExpressionNode* Parser::evalBitShift() {
 
   AbstractExpressionNode* head = evalAddSubtract();
   AbstractExpressionNode* next;
@@ -872,7 +904,7 @@ AbstractExpressionNode* evalBitShift() {
 
 
 // < <= > >=
-AbstractExpressionNode* evalComparison() {
+AbstractExpressionNode* Parser::evalComparison() {
 
   AbstractExpressionNode* head = evalBitShift();
   AbstractExpressionNode* next;
@@ -892,7 +924,7 @@ AbstractExpressionNode* evalComparison() {
 }
 
 // == and !=
-AbstractExpressionNode* evalEquality() {
+AbstractExpressionNode* Parser::evalEquality() {
 
   AbstractExpressionNode* head = evalComparison();
   AbstractExpressionNode* next;
@@ -912,7 +944,7 @@ AbstractExpressionNode* evalEquality() {
 }
 
 // &
-AbstractExpressionNode* evalBitAnd() {
+AbstractExpressionNode* Parser::evalBitAnd() {
 
   AbstractExpressionNode* head = evalEquality();
   AbstractExpressionNode* next;
@@ -933,7 +965,7 @@ AbstractExpressionNode* evalBitAnd() {
 
 
 // ^
-AbstractExpressionNode* evalBitXor() {
+AbstractExpressionNode* Parser::evalBitXor() {
 
   AbstractExpressionNode* head = evalBitAnd();
   AbstractExpressionNode* next;
@@ -953,7 +985,7 @@ AbstractExpressionNode* evalBitXor() {
 }
 
 // |
-AbstractExpressionNode* evalBitOr() {
+AbstractExpressionNode* Parser::evalBitOr() {
 
   AbstractExpressionNode* head = evalBitXor();
   AbstractExpressionNode* next;
@@ -974,7 +1006,7 @@ AbstractExpressionNode* evalBitOr() {
 
 
 // &&
-AbstractExpressionNode* evalLogicAnd() {
+AbstractExpressionNode* Parser::evalLogicAnd() {
 
   AbstractExpressionNode* head = evalBitOr();
   AbstractExpressionNode* next;
@@ -995,7 +1027,7 @@ AbstractExpressionNode* evalLogicAnd() {
 
 
 // ^^
-AbstractExpressionNode* evalLogicXor() {
+AbstractExpressionNode* Parser::evalLogicXor() {
 
   AbstractExpressionNode* head = evalLogicAnd();
   AbstractExpressionNode* next;
@@ -1015,7 +1047,7 @@ AbstractExpressionNode* evalLogicXor() {
 }
 
 // ||
-AbstractExpressionNode* evalLogicOr() {
+AbstractExpressionNode* Parser::evalLogicOr() {
 
   AbstractExpressionNode* head = evalLogicXor();
   AbstractExpressionNode* next;
@@ -1036,7 +1068,7 @@ AbstractExpressionNode* evalLogicOr() {
 
 
 //  = += -= *= **= /= &= ^= |= <<= >>=
-AbstractExpressionNode* evalAssignment() {
+AbstractExpressionNode* Parser::evalAssignment() {
   
   AbstractExpressionNode* head = evalLogicOr();
   VariableNode* var = dynamic_cast<VariableNode*>(head);
@@ -1137,12 +1169,12 @@ AbstractExpressionNode* evalAssignment() {
   }
 }
 
-AbstractExpressionNode* evalExpression() {
+AbstractExpressionNode* Parser::evalExpression() {
   return evalAssignment();
 }
 
 
-AbstractStatementNode* addStatement() {
+AbstractStatementNode* Parser::addStatement() {
 
   Token* t = peek();
   
@@ -1259,6 +1291,13 @@ AbstractStatementNode* addStatement() {
     Token* varToken = consume();
     string variable(varToken->lexeme);
     
+		//if it is a function call, treat it like an "expression" statement
+		//(built-in and native functions aren't declared, the expression checks the name)
+		if(peek()->type == LEFT_PAREN) {
+			stepBack();
+			return new ExpressionStatementNode(evalExpression(), symbolTable);
+		}
+
     //make sure variable is already declared in some scope
     if(!symbolTable->isDeclared(variable)) {
       throw StaticVariableScopeError(varToken->line+1, varToken->lexeme, getCodeLineBlock(varToken->line, varToken->line), false);
@@ -1270,12 +1309,6 @@ AbstractStatementNode* addStatement() {
 			return new ExpressionStatementNode(evalPostfixMemberAccess(), symbolTable);
 		}
 
-		//if it is a function call, treat it like an "expression" statement
-		if(peek()->type == LEFT_PAREN) {
-			stepBack();
-			return new ExpressionStatementNode(evalExpression(), symbolTable);
-		}
-
     //get variable type (and maybe array/string element subtype) from the symbol table
 		ParseDataType type;
 		ParseDataType subtype = INVALID_T;
@@ -1407,11 +1440,74 @@ AbstractStatementNode* addStatement() {
       consume();
       return new PrintStatementNode(evalExpression(), symbolTable, t->line+1);
     }
+
+    case PRINTF: {
+      Token* printfToken = consume();
+      uint32_t startLine = printfToken->line+1;
+
+      //the format has to be known here so the arguments can be checked against it
+      AbstractExpressionNode* format = evalExpression();
+      LiteralNode* literal = dynamic_cast<LiteralNode*>(format);
+
+      if(literal == NULL || format->evalType != STRING_T) {
+        throw ParseSyntaxError(startLine, format->endLine, getCodeLineBlock(startLine-1, format->endLine-1), "Expected a string literal as the printf format");
+      }
+
+      vector<FormatSpecifier>* specifiers = newFormatList();
+      const char* formatError = parseFormat((char*) literal->data.value.allocated, *specifiers);
+
+      if(formatError != NULL) {
+        throw ParseSyntaxError(startLine, format->endLine, getCodeLineBlock(startLine-1, format->endLine-1), formatError);
+      }
+
+      vector<AbstractExpressionNode*> arguments;
+      uint32_t endLine = format->endLine;
+
+      while(peek()->type == COMMA) {
+        consume(); //consume ,
+        arguments.push_back(evalExpression());
+        endLine = arguments.back()->endLine;
+      }
+
+      //one argument per conversion, of a type the conversion can print
+      uint32_t numArgs = 0;
+      for(uint32_t i = 0; i < specifiers->size(); i++) {
+
+        char conversion = (*specifiers)[i].conversion;
+        if(!consumesValue(conversion))
+          continue;
+
+        if(numArgs == arguments.size()) {
+          throw ParseSyntaxError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), "Too few arguments provided for this printf format");
+        }
+
+        AbstractExpressionNode* argument = arguments[numArgs++];
+        if(!acceptsType(conversion, argument->evalType)) {
+
+          string message = "Cannot print a ";
+          message.append(toStringParseDataType(argument->evalType));
+          message.append(" argument with %");
+          message.push_back(conversion);
+
+          throw StaticTypeError(startLine, argument->endLine, getCodeLineBlock(startLine-1, argument->endLine-1), copyString(message.c_str()));
+        }
+      }
+
+      if(numArgs < arguments.size()) {
+        throw ParseSyntaxError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), "Too many arguments provided for this printf format");
+      }
+
+      AbstractExpressionNode** argumentArray = (AbstractExpressionNode**) allocateProgram(sizeof(AbstractExpressionNode*) * numArgs);
+      for(uint32_t i = 0; i < numArgs; i++)
+        argumentArray[i] = arguments[i];
+
+      return new PrintFormattedStatementNode(format, specifiers, numArgs, argumentArray, symbolTable, startLine, endLine);
+    }
     
     case LEFT_BRACE: {
       
 			Token* leftBraceToken = consume();
-      vector<AbstractStatementNode*>* statements = new vector<AbstractStatementNode*>();
+      vector<AbstractStatementNode*>* statements = newStatementList();
       
       //enter a new scope in both symbol tables (for static scope-checking)
       symbolTable->enterNewScope();
@@ -1462,6 +1558,45 @@ AbstractStatementNode* addStatement() {
       AbstractStatementNode* body = addStatement();
       return new WhileStatementNode(condition, body, symbolTable, whileToken->line+1);
     }
+
+    case BENCH: {
+
+      Token* benchToken = consume(); //consume bench Token
+      uint32_t startLine = benchToken->line+1;
+
+      //the name shows up in the report, so it has to be known here
+      AbstractExpressionNode* name = evalExpression();
+      LiteralNode* literal = dynamic_cast<LiteralNode*>(name);
+
+      if(literal == NULL || name->evalType != STRING_T) {
+        throw ParseSyntaxError(startLine, name->endLine, getCodeLineBlock(startLine-1, name->endLine-1), "Expected a string literal as the bench name");
+      }
+
+      //an optional number of runs comes before the block
+      AbstractExpressionNode* runs = NULL;
+      uint32_t endLine = name->endLine;
+
+      if(peek()->type != LEFT_BRACE) {
+        runs = evalExpression();
+        endLine = runs->endLine;
+
+        if(!typecheckImplicitCastExpression(runs->evalType, INT32_T)) {
+
+          string message = "Expected int expression for the number of bench runs, not a ";
+          message.append(toStringParseDataType(runs->evalType));
+          message.append(" one");
+
+          throw StaticTypeError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), copyString(message.c_str()));
+        }
+      }
+
+      if(peek()->type != LEFT_BRACE) {
+        throw ParseSyntaxError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), "Expected '{' to start the bench block");
+      }
+
+      AbstractStatementNode* body = addStatement();
+      return new BenchStatementNode((char*) literal->data.value.allocated, runs, body, symbolTable, startLine);
+    }
     
     case FOR: {
       
@@ -1553,8 +1688,8 @@ AbstractStatementNode* addStatement() {
     
     case IF: {
     
-      vector<AbstractExpressionNode*>* cond = new vector<AbstractExpressionNode*>();
-      vector<AbstractStatementNode*>* stat = new vector<AbstractStatementNode*>();
+      vector<AbstractExpressionNode*>* cond = newExpressionList();
+      vector<AbstractStatementNode*>* stat = newStatementList();
 			uint32_t currentEndLine;
       
       //consume the IF token and add first condition-statement pair
@@ -1648,7 +1783,7 @@ AbstractStatementNode* addStatement() {
 				throw StaticCastError(startLine, endLine, getCodeLineBlock(startLine-1, endLine-1), returnExpression->evalType, returnType.back(), false);
 			}
 
-			return new ReturnStatementNode(returnExpression, returnFlag.back(), returnValue.back(), returnToken->line+1);
+			return new ReturnStatementNode(returnExpression, returnToken->line+1);
 		}
 
 		case FUN: {
@@ -1682,22 +1817,21 @@ AbstractStatementNode* addStatement() {
   
 }
 
-//generate Abstract Syntax Tree from list of tokens
-vector<AbstractStatementNode*>* parse(vector<Token>* tokenRef, vector<char*>* sourceCodeLines) {
-
-  codeLines = sourceCodeLines;
+Parser::Parser(vector<Token>* tokenRef, vector<char*>* sourceCodeLines, SymbolTable* table) {
 
-  //set static variables to correct initial values
+  //set variables to correct initial values
   tokenIndex = 0;
   tokens = tokenRef;
-  symbolTable = new SymbolTable();
-	returnFlag = vector<bool*>();
-	returnValue = vector<ParseData*>();
-	returnType = vector<ParseDataType>();
-	insideClassDefinition = false;
+  codeLines = sourceCodeLines;
+  symbolTable = table;
+  insideClassDefinition = false;
+}
+
+//generate Abstract Syntax Tree from list of tokens
+vector<AbstractStatementNode*>* Parser::parse() {
   
   //create empty statement vector
-  vector<AbstractStatementNode*>* statements = new vector<AbstractStatementNode*>();
+  vector<AbstractStatementNode*>* statements = newStatementList();
   
   //append statement nodes until END is reached
   while(peek()->type != END) {
@@ -1707,4 +1841,7 @@ vector<AbstractStatementNode*>* parse(vector<Token>* tokenRef, vector<char*>* so
   return statements;
 }
 
-
+vector<AbstractStatementNode*>* parse(vector<Token>* tokens, vector<char*>* codeLines, SymbolTable* symbolTable) {
+  Parser parser(tokens, codeLines, symbolTable);
+  return parser.parse();
+}
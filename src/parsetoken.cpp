@@ -7,6 +7,8 @@
 #include "parsetoken.h"
 #include "array.h"
 #include "utils.h"
+#include "numconv.h"
+#include "scratch.h"
 
 static const ParseDataType signedIntegerTypes[] = {INT8_T, INT16_T, INT32_T, INT64_T}; 
 static const ParseDataType unsignedIntegerTypes[] = {UINT8_T, UINT16_T, UINT32_T, UINT64_T}; 
@@ -33,11 +35,11 @@ ParseData copyParseData(ParseData d) {
 		uint32_t length = arr->length;
 		ParseData* values = arr->values;
 
-		Array* arr2 = (Array*) malloc(sizeof(Array));
+		Array* arr2 = (Array*) allocateHeap(sizeof(Array));
 		arr2->length = length;
 		arr2->subtype = arr->subtype;
 
-		ParseData* values2 = (ParseData*) malloc(sizeof(ParseData)*std::max((int32_t)length, 1));
+		ParseData* values2 = (ParseData*) allocateHeap(sizeof(ParseData)*std::max((int32_t)length, 1));
 		for(uint32_t i = 0; i < length; i++) {
 			values2[i] = copyParseData(values[i]);
 		}
@@ -219,6 +221,16 @@ ParseOperatorType binaryTokenConversion(TokenType tt) {
   }  
 }
 
+BuiltinFunction nameBuiltinConversion(const char* name) {
+
+  for(int f = 0; f < INVALID_FUN; f++) {
+    if(strcmp(name, toStringBuiltinFunction((BuiltinFunction) f)) == 0)
+      return (BuiltinFunction) f;
+  }
+
+  return INVALID_FUN;
+}
+
 
 
 ////////////////////////////////////
@@ -244,6 +256,16 @@ const char* toStringParseDataType(ParseDataType p) {
   } 
 }
 
+//returns the name a BuiltinFunction is called by
+const char* toStringBuiltinFunction(BuiltinFunction f) {
+
+  switch(f) {
+    case NANOTIME_FUN: return "nanotime";
+    case CPUTIME_FUN: return "cputime";
+    default: return "invalid";
+  }
+}
+
 //returns string representation of ParseOperatorType enum
 const char* toStringParseOperatorType(ParseOperatorType p) {
 
@@ -358,69 +380,104 @@ const char* toWordParseOperatorType(ParseOperatorType p) {
 }
 
 
+//appends the same text as toStringParseData without allocating each element
+static void appendParseData(std::string& str, ParseData d) {
+
+  char text[MAX_NUMBER_LENGTH];
+
+  switch(d.type) {
+    case INT32_T: str.append(text, formatSigned((int32_t) d.value.integer, text)); break;
+    case INT64_T: str.append(text, formatSigned((int64_t) d.value.integer, text)); break;
+    case UINT32_T: str.append(text, formatUnsigned((uint32_t) d.value.integer, text)); break;
+    case UINT64_T: str.append(text, formatUnsigned((uint64_t) d.value.integer, text)); break;
+    case DOUBLE_T: str.append(text, formatDouble((double) d.value.floatingPoint, text)); break;
+    case STRING_T: str.append((char*) d.value.allocated); break;
+    case BOOL_T: str.append(d.value.integer ? "true" : "false"); break;
+
+    //a null char ends the string it would have been converted to
+    case CHAR_T: {
+      if((uint8_t) d.value.integer != 0)
+        str.push_back((char) d.value.integer);
+      break;
+    }
+
+    case ARRAY_T: {
+      Array* arr = (Array*) d.value.allocated;
+
+      str.push_back('[');
+      for(uint32_t i = 0; i < arr->length; i++) {
+        if(i > 0)
+          str.append(", ");
+        appendParseData(str, arr->values[i]);
+      }
+      str.push_back(']');
+      break;
+    }
+
+    default: {
+      char* value = toStringParseData(d);
+      str.append(value);
+      break;
+    }
+  }
+}
+
 char* toStringParseData(ParseData d) {
 
+  char text[MAX_NUMBER_LENGTH + 1];
+
   switch(d.type) {
 
     case INT8_T: {
       int8_t val = (int8_t) d.value.integer;
-      std::string str = std::to_string(val);
-      return copyString(str.c_str());
+      return copyNumber(text, formatSigned(val, text));
     }
 
     case INT16_T: {
       int16_t val = (int16_t) d.value.integer;  
-      std::string str = std::to_string(val);
-      return copyString(str.c_str());
+      return copyNumber(text, formatSigned(val, text));
     }
 
     case INT32_T: {
       int32_t val = (int32_t) d.value.integer;
-      std::string str = std::to_string(val);
-      return copyString(str.c_str());
+      return copyNumber(text, formatSigned(val, text));
     }
 
     case INT64_T: {
       int64_t val = (int64_t) d.value.integer;
-      std::string str = std::to_string(val);
-      return copyString(str.c_str());
+      return copyNumber(text, formatSigned(val, text));
     }
 
     case UINT8_T: {
       uint8_t val = (uint8_t) d.value.integer;
-      std::string str = std::to_string(val);
-      return copyString(str.c_str());
+      return copyNumber(text, formatUnsigned(val, text));
     }
 
     case UINT16_T: {
       uint16_t val = (uint16_t) d.value.integer;  
-      std::string str = std::to_string(val);
-      return copyString(str.c_str());
+      return copyNumber(text, formatUnsigned(val, text));
     }
 
     case UINT32_T: {
       uint32_t val = (uint32_t) d.value.integer;
-      std::string str = std::to_string(val);
-      return copyString(str.c_str());
+      return copyNumber(text, formatUnsigned(val, text));
     }
 
     case UINT64_T: {
       uint64_t val = (uint64_t) d.value.integer;
-      std::string str = std::to_string(val);
-      return copyString(str.c_str());
+      return copyNumber(text, formatUnsigned(val, text));
     }
 
     case CHAR_T: {
       char val = (char) ((uint8_t) d.value.integer);
-      char* c = new char[2];
+      char* c = (char*) allocateHeap(2);
       c[0] = val;
       c[1] = '\0';
       return c; 
     }
 
     case DOUBLE_T: {
-      std::string str = std::to_string((double) d.value.floatingPoint);
-      return copyString(str.c_str());
+      return copyNumber(text, formatDouble((double) d.value.floatingPoint, text));
     }
     
     case BOOL_T: {
@@ -437,22 +494,8 @@ char* toStringParseData(ParseData d) {
     }
 
 		case ARRAY_T: {
-
-			Array* arr = (Array*) d.value.allocated;
-			uint32_t length = arr->length;
-			ParseData* values = arr->values;
-
-			std::string str("[");
-
-			if(length > 0)
-				str.append(toStringParseData(values[0]));
-			
-			for(uint32_t i = 1; i < length; i++) {
-				str.append(", ");
-				str.append(toStringParseData(values[i]));
-			}
-			str.append("]");
-
+			std::string str;
+			appendParseData(str, d);
 			return copyString(str.c_str());
 		}
 		
@@ -0,0 +1,195 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <csignal>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ctime>
+#include <sys/time.h>
+#include "numconv.h"
+#include "profile.h"
+
+//rows of the hotspot table
+#define PROFILE_TABLE_LINES 20
+
+thread_local ProfileFrame profileStack[MAX_PROFILE_DEPTH] = {{"<main>", 0}};
+thread_local ProfileFrame* profileTop = NULL;
+thread_local uint32_t profileDepth = 0;
+
+volatile sig_atomic_t pendingSamples = 0;
+
+//samples of one source line, self while it was the innermost running line
+struct LineSamples {
+	const char* function;
+	uint64_t self;
+	uint64_t total;
+};
+
+static const char* profiledFile;
+static std::vector<char*>* profiledLines;
+static const char* foldedFile;
+static uint32_t interval;
+static double startCpuSeconds;
+
+static uint64_t totalSamples = 0;
+static std::map<uint32_t, LineSamples> lineSamples;
+static std::map<std::string, uint64_t> foldedStacks;
+
+//only counts the tick, the stack is read at the next statement where it is safe to allocate
+static void onProfileTimer(int) {
+	pendingSamples = pendingSamples + 1;
+}
+
+static double cpuSeconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void appendFrame(std::string& stack, ProfileFrame& frame) {
+
+	char line[MAX_NUMBER_LENGTH + 1];
+	line[formatUnsigned(frame.line, line)] = '\0';
+
+	stack.append(frame.function);
+	stack.append(" (");
+	stack.append(profiledFile);
+	stack.append(":");
+	stack.append(line);
+	stack.append(")");
+}
+
+void takeSample() {
+
+	uint64_t ticks = pendingSamples;
+	pendingSamples = 0;
+	totalSamples += ticks;
+
+	//a function that hasn't reached its first statement is still its caller's line
+	int32_t top = std::min(profileDepth, (uint32_t) MAX_PROFILE_DEPTH - 1);
+	while(top > 0 && profileStack[top].line == 0)
+		top--;
+
+	std::string stack;
+	std::set<uint32_t> counted;
+
+	for(int32_t i = 0; i <= top; i++) {
+		ProfileFrame& frame = profileStack[i];
+
+		if(i > 0)
+			stack.append(";");
+		appendFrame(stack, frame);
+
+		//recursion puts a line on the stack many times, but it only counts once per sample
+		if(counted.insert(frame.line).second) {
+			LineSamples& samples = lineSamples[frame.line];
+			samples.function = frame.function;
+			samples.total += ticks;
+		}
+	}
+
+	lineSamples[profileStack[top].line].self += ticks;
+	foldedStacks[stack] += ticks;
+}
+
+static bool hotterLine(const std::pair<uint32_t, LineSamples>& a, const std::pair<uint32_t, LineSamples>& b) {
+	if(a.second.self != b.second.self)
+		return a.second.self > b.second.self;
+	if(a.second.total != b.second.total)
+		return a.second.total > b.second.total;
+	return a.first < b.first;
+}
+
+std::string sourceLine(std::vector<char*>* codeLines, uint32_t line) {
+
+	if(line == 0 || line > codeLines->size())
+		return "";
+
+	std::string text(codeLines->at(line - 1));
+	size_t start = text.find_first_not_of(" \t");
+	size_t end = text.find_last_not_of(" \t\r\n");
+	if(start == std::string::npos)
+		return "";
+
+	return text.substr(start, end - start + 1);
+}
+
+static void writeFoldedStacks() {
+
+	FILE* out = fopen(foldedFile, "w");
+	if(out == NULL) {
+		fprintf(stderr, "Couldn't write the profile to %s: %s\n", foldedFile, strerror(errno));
+		return;
+	}
+
+	for(std::map<std::string, uint64_t>::iterator it = foldedStacks.begin(); it != foldedStacks.end(); it++)
+		fprintf(out, "%s %llu\n", it->first.c_str(), (unsigned long long) it->second);
+
+	fclose(out);
+}
+
+static void writeHotspots() {
+
+	std::vector<std::pair<uint32_t, LineSamples> > lines(lineSamples.begin(), lineSamples.end());
+	std::sort(lines.begin(), lines.end(), hotterLine);
+
+	//the kernel may deliver the timer less often than asked, so the real rate is shown too
+	fprintf(stderr, "profile: %llu samples in %.1f ms of CPU time (asked for one every %u us), folded stacks in %s\n",
+		(unsigned long long) totalSamples, (cpuSeconds() - startCpuSeconds) * 1000, interval, foldedFile);
+
+	if(totalSamples == 0)
+		return;
+
+	fprintf(stderr, "%7s %8s %7s %8s %6s  %-16s %s\n", "self %", "self", "total %", "total", "line", "function", "source");
+
+	for(uint32_t i = 0; i < lines.size() && i < PROFILE_TABLE_LINES; i++) {
+		LineSamples& samples = lines[i].second;
+		fprintf(stderr, "%7.1f %8llu %7.1f %8llu %6u  %-16s %s\n",
+			100.0 * samples.self / totalSamples, (unsigned long long) samples.self,
+			100.0 * samples.total / totalSamples, (unsigned long long) samples.total,
+			lines[i].first, samples.function, sourceLine(profiledLines, lines[i].first).c_str());
+	}
+}
+
+static void writeProfile() {
+
+	struct itimerval stopped;
+	memset(&stopped, 0, sizeof(stopped));
+	setitimer(ITIMER_PROF, &stopped, NULL);
+
+	if(pendingSamples)
+		takeSample();
+
+	writeFoldedStacks();
+	writeHotspots();
+}
+
+void startProfiling(const char* sourceFile, std::vector<char*>* codeLines, const char* folded, uint32_t intervalMicros) {
+
+	const char* slash = strrchr(sourceFile, '/');
+	profiledFile = (slash != NULL) ? slash + 1 : sourceFile;
+	profiledLines = codeLines;
+	foldedFile = folded;
+	interval = intervalMicros;
+	startCpuSeconds = cpuSeconds();
+
+	atexit(writeProfile);
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = onProfileTimer;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGPROF, &action, NULL);
+
+	struct itimerval timer;
+	timer.it_interval.tv_sec = intervalMicros / 1000000;
+	timer.it_interval.tv_usec = intervalMicros % 1000000;
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_PROF, &timer, NULL);
+}
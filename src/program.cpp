@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "parsenode.h"
+#include "statementnode.h"
+#include "function.h"
+#include "scratch.h"
+#include "program.h"
+
+thread_local CompiledProgram* compilingProgram = NULL;
+
+CompiledProgram::CompiledProgram() {
+	codeLines = NULL;
+	symbolTable = NULL;
+	statements = NULL;
+	numSlots = 0;
+}
+
+CompiledProgram::~CompiledProgram() {
+
+	for(uint32_t i = 0; i < expressionNodes.size(); i++)
+		delete expressionNodes[i];
+	for(uint32_t i = 0; i < statementNodes.size(); i++)
+		delete statementNodes[i];
+
+	for(uint32_t i = 0; i < expressionLists.size(); i++)
+		delete expressionLists[i];
+	for(uint32_t i = 0; i < statementLists.size(); i++)
+		delete statementLists[i];
+	for(uint32_t i = 0; i < formatLists.size(); i++)
+		delete formatLists[i];
+
+	delete symbolTable;
+	delete codeLines;
+
+	for(uint32_t i = 0; i < memory.size(); i++)
+		free(memory[i]);
+}
+
+void* allocateProgram(size_t size) {
+	void* memory = calloc(1, size);
+	if(compilingProgram != NULL)
+		compilingProgram->memory.push_back(memory);
+	return memory;
+}
+
+//lists made while no program is being compiled are never freed
+std::vector<AbstractExpressionNode*>* newExpressionList() {
+	std::vector<AbstractExpressionNode*>* list = new std::vector<AbstractExpressionNode*>();
+	if(compilingProgram != NULL)
+		compilingProgram->expressionLists.push_back(list);
+	return list;
+}
+
+std::vector<AbstractStatementNode*>* newStatementList() {
+	std::vector<AbstractStatementNode*>* list = new std::vector<AbstractStatementNode*>();
+	if(compilingProgram != NULL)
+		compilingProgram->statementLists.push_back(list);
+	return list;
+}
+
+std::vector<FormatSpecifier>* newFormatList() {
+	std::vector<FormatSpecifier>* list = new std::vector<FormatSpecifier>();
+	if(compilingProgram != NULL)
+		compilingProgram->formatLists.push_back(list);
+	return list;
+}
+
+CompilingScope::CompilingScope(CompiledProgram* program) {
+	previous = compilingProgram;
+	compilingProgram = program;
+	previousHeapOwner = setHeapOwner(&program->memory);
+}
+
+CompilingScope::~CompilingScope() {
+	compilingProgram = previous;
+	setHeapOwner(previousHeapOwner);
+}
+
+//convert source code into array of lines
+std::vector<char*>* getLines(char* code) {
+
+	std::vector<char*>* lines = new std::vector<char*>();
+	uint32_t codeIndex = 0;
+
+	while(code[codeIndex]) {
+
+		//edge cases
+		if(code[codeIndex] == '\n') {
+			char* c = (char*) allocateProgram(2);
+			c[0] = '\n'; c[1] = '\0';
+			lines->push_back(c);
+			codeIndex++;
+			continue;
+		}
+
+		//setup
+		uint32_t start = codeIndex;
+		uint32_t end = codeIndex;
+
+		while(code[end] != '\n' && code[end] != '\0') {
+			end++;
+		}
+
+		char* c = (char*) allocateProgram(end-start+2);
+		for(uint32_t i = start; i < end; i++) {
+			c[i-start] = code[i];
+		}
+		c[end-start] = '\n';
+		c[end-start+1] = '\0';
+
+		lines->push_back(c);
+
+		//the last line doesn't have to end with a newline
+		codeIndex = (code[end] == '\n') ? end+1 : end;
+	}
+
+	return lines;
+}
@@ -0,0 +1,167 @@
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include "scratch.h"
+#include "stats.h"
+#include "allocprofile.h"
+#include "budget.h"
+
+//size of a regular block, larger values get a block of their own
+#define SCRATCH_BLOCK_SIZE 65536
+
+struct ScratchBlock {
+	char* memory;
+	size_t size;
+};
+
+//blocks are kept after a release and reused, so steady state does no mallocs at all
+//they're only freed when their thread exits
+struct ScratchBlocks : std::vector<ScratchBlock> {
+	~ScratchBlocks() {
+		for(uint32_t i = 0; i < size(); i++)
+			free((*this)[i].memory);
+	}
+};
+
+static thread_local ScratchBlocks blocks;
+static thread_local uint32_t current = 0;
+static thread_local size_t used = 0;
+static thread_local size_t live = 0;
+
+static thread_local bool enabled = false;
+
+//heap values are only freed when the interpreter exits (or the run ends), except the few given to freeHeap
+static thread_local size_t heapBytes = 0;
+static thread_local size_t heapLimit = SIZE_MAX;
+
+static thread_local std::vector<void*>* heapOwner = NULL;
+
+void setHeapLimit(size_t bytes) {
+	heapBytes = 0;
+	heapLimit = bytes;
+}
+
+std::vector<void*>* setHeapOwner(std::vector<void*>* owner) {
+	std::vector<void*>* previous = heapOwner;
+	heapOwner = owner;
+	return previous;
+}
+
+ScratchMark scratchMark() {
+	ScratchMark mark;
+	mark.block = current;
+	mark.used = used;
+	mark.live = live;
+	return mark;
+}
+
+void scratchRelease(ScratchMark mark) {
+	current = mark.block;
+	used = mark.used;
+	live = mark.live;
+}
+
+size_t scratchLiveBytes() {
+	return live;
+}
+
+static void* scratchAllocate(size_t size) {
+
+	//keep every value aligned like malloc would
+	size = (size + 15) & ~(size_t) 15;
+	live += size;
+
+	while(current < blocks.size()) {
+		if(used + size <= blocks[current].size) {
+			void* memory = blocks[current].memory + used;
+			used += size;
+			return memory;
+		}
+
+		current++;
+		used = 0;
+
+		//a block that is too small for this value is swapped for one that fits
+		if(current < blocks.size() && blocks[current].size < size) {
+			free(blocks[current].memory);
+			blocks[current].memory = (char*) malloc(size);
+			blocks[current].size = size;
+		}
+	}
+
+	ScratchBlock block;
+	block.size = (size > SCRATCH_BLOCK_SIZE) ? size : SCRATCH_BLOCK_SIZE;
+	block.memory = (char*) malloc(block.size);
+	blocks.push_back(block);
+
+	current = blocks.size()-1;
+	used = size;
+	return block.memory;
+}
+
+//reporting the error allocates too, and the program stops, so nothing is limited after it
+static void passHeapLimit(size_t size) {
+	heapLimit = SIZE_MAX;
+	exceedHeapLimit(size);
+}
+
+void* allocateValue(size_t size) {
+
+	if(!enabled)
+		return allocateHeap(size);
+
+	if(heapBytes + live + size > heapLimit)
+		passHeapLimit(size);
+
+	runCounters.allocations++;
+	runCounters.scratchAllocations++;
+	runCounters.allocatedBytes += size;
+
+	void* memory = scratchAllocate(size);
+	if(allocProfiling)
+		recordAllocation(size, true);
+	return memory;
+}
+
+void* allocateHeap(size_t size) {
+	if(heapBytes + live + size > heapLimit)
+		passHeapLimit(size);
+	heapBytes += size;
+
+	runCounters.allocations++;
+	runCounters.allocatedBytes += size;
+
+	if(allocProfiling)
+		recordAllocation(size, false);
+
+	void* memory = malloc(size);
+	if(heapOwner != NULL)
+		heapOwner->push_back(memory);
+	return memory;
+}
+
+void freeHeap(void* memory, size_t size) {
+	heapBytes -= size;
+	if(allocProfiling)
+		recordFree(size);
+
+	if(heapOwner != NULL) {
+		//it's almost always the last one allocated
+		for(size_t i = heapOwner->size(); i-- > 0; ) {
+			if((*heapOwner)[i] == memory) {
+				heapOwner->erase(heapOwner->begin() + i);
+				break;
+			}
+		}
+	}
+	free(memory);
+}
+
+ScratchScope::ScratchScope(bool enable) {
+	previous = enabled;
+	enabled = enable;
+}
+
+ScratchScope::~ScratchScope() {
+	enabled = previous;
+}
@@ -1,11 +1,28 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <cstdio>
 #include "parsetoken.h"
 #include "parsenode.h"
 #include "statementnode.h"
 #include "symboltable.h"
 #include "executor.h"
 #include "array.h"
+#include "scratch.h"
+#include "stats.h"
+#include "profile.h"
+#include "trace.h"
+#include "budget.h"
+#include "context.h"
+#include "counters.h"
+#include "builtineval.h"
+#include "output.h"
+#include "program.h"
+
+AbstractStatementNode::AbstractStatementNode() {
+  if(compilingProgram != NULL)
+    compilingProgram->statementNodes.push_back(this);
+}
 
 //represents a single-expression statement
 ExpressionStatementNode::ExpressionStatementNode(AbstractExpressionNode* exp, SymbolTable* symbolTable) {
@@ -16,6 +33,10 @@ ExpressionStatementNode::ExpressionStatementNode(AbstractExpressionNode* exp, Sy
 }
 
 void ExpressionStatementNode::execute() {
+  COUNT_NODE("ExpressionStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
   executeExpressionStatement(this);
 }
 
@@ -28,6 +49,10 @@ PrintStatementNode::PrintStatementNode(AbstractExpressionNode* exp, SymbolTable*
 }
 
 void PrintStatementNode::execute() {
+  COUNT_NODE("PrintStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
   executePrintStatement(this);
 }
 
@@ -40,9 +65,33 @@ PrintLineStatementNode::PrintLineStatementNode(AbstractExpressionNode* exp, Symb
 }
 
 void PrintLineStatementNode::execute() {
+  COUNT_NODE("PrintLineStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
   executePrintLineStatement(this);
 }
 
+//represents printf statement
+PrintFormattedStatementNode::PrintFormattedStatementNode(AbstractExpressionNode* format, std::vector<FormatSpecifier>* specifiers, uint32_t numArgs,
+    AbstractExpressionNode** arguments, SymbolTable* symbolTable, uint32_t startLine, uint32_t endLine) {
+  this->format = format;
+  this->specifiers = specifiers;
+  this->numArgs = numArgs;
+  this->arguments = arguments;
+  this->symbolTable = symbolTable;
+	this->startLine = startLine;
+	this->endLine = endLine;
+}
+
+void PrintFormattedStatementNode::execute() {
+  COUNT_NODE("PrintFormattedStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
+  executePrintFormattedStatement(this);
+}
+
 
 //represents a group of statements in braces
 GroupedStatementNode::GroupedStatementNode(std::vector<AbstractStatementNode*>* s, SymbolTable* symbolTable, uint32_t startLine, uint32_t endLine) {
@@ -53,6 +102,10 @@ GroupedStatementNode::GroupedStatementNode(std::vector<AbstractStatementNode*>*
 }
 
 void GroupedStatementNode::execute() {
+  COUNT_NODE("GroupedStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
   executeGroupedStatement(this);
 }
 
@@ -66,6 +119,10 @@ ConditionalStatementNode::ConditionalStatementNode(std::vector<AbstractExpressio
 }
 
 void ConditionalStatementNode::execute() {
+  COUNT_NODE("ConditionalStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
   executeConditionalStatement(this);
 }
 
@@ -79,16 +136,32 @@ WhileStatementNode::WhileStatementNode(AbstractExpressionNode* cond, AbstractSta
 }
 
 void WhileStatementNode::execute() {
+  COUNT_NODE("WhileStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
+  uint64_t traceStart = tracing ? traceClock() : 0;
+
+  //temporaries of an iteration are gone once the condition is checked again
+  ScratchMark mark = scratchMark();
   
   //execute the body while the condition evaluates to true
   ParseData d = condition->evaluate();
+  scratchRelease(mark);
+
   while(d.type == BOOL_T && d.value.integer) {
     
     body->execute();
     
     //get updated expression truth value
+    profileLine(startLine);
+    burnFuel(startLine);
     d = condition->evaluate();
+    scratchRelease(mark);
   }
+
+  if(tracing)
+    traceSpan("while", "loop", traceStart, startLine);
 }
 
 //represents for loop
@@ -100,26 +173,146 @@ ForStatementNode::ForStatementNode(AbstractStatementNode* init, AbstractStatemen
   this->symbolTable = symbolTable;
 	this->startLine = startLine;
 	this->endLine = bod->endLine;
+  rangeLimit = NULL;
+  inRange = NO_SLOT;
 }
 
 void ForStatementNode::execute() {
+  COUNT_NODE("ForStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
+  uint64_t traceStart = tracing ? traceClock() : 0;
 
+  SymbolTable* symbolTable = &runningContext->variables;
   symbolTable->enterNewScope();
+  ScratchMark mark = scratchMark();
 
   //first run initialization statement
   initialization->execute();
-  
+
+  //products of the loop variable start from their actual values
+  uint32_t numInductionVariables = inductionVariables.size();
+  ParseData* slots = runningContext->slots;
+  for(uint32_t i = 0; i < numInductionVariables; i++) {
+    slots[inductionVariables[i].value] = inductionVariables[i].product->evaluate();
+  }
+
   //now execute the body while the terminating condition is true
   ParseData d = condition->evaluate();
+  scratchRelease(mark);
+
+  //indices stay below the limit, so one length check per array covers every access
+  if(inRange != NO_SLOT && d.type == BOOL_T && d.value.integer) {
+    ParseData limit = rangeLimit->evaluate();
+    bool fits = limit.type == INT32_T;
+
+    for(uint32_t i = 0; fits && i < guardedArrays.size(); i++) {
+      ParseData arr = symbolTable->get(guardedArrays[i]);
+      fits = arr.type == ARRAY_T && (int32_t) limit.value.integer <= (int32_t) ((Array*) arr.value.allocated)->length;
+    }
+
+    slots[inRange].value.integer = fits;
+  }
+  
   while(d.type == BOOL_T && d.value.integer) {
     body->execute();
     
     //update statement
     update->execute();
+
+    //integer products wrap the same way the additions do
+    for(uint32_t i = 0; i < numInductionVariables; i++) {
+      ParseData* value = &slots[inductionVariables[i].value];
+      uint64_t next = value->value.integer + inductionVariables[i].increment;
+      value->value.integer = (value->type == INT32_T) ? (int32_t) next : next;
+    }
+
+    burnFuel(startLine);
     d = condition->evaluate();
+    scratchRelease(mark);
   }
   
   symbolTable->leaveScope();
+
+  if(tracing)
+    traceSpan("for", "loop", traceStart, startLine);
+}
+
+static uint32_t benchRuns = 10;
+static uint32_t benchWarmupRuns = 2;
+
+void setBenchRuns(uint32_t runs, uint32_t warmupRuns) {
+  benchRuns = runs;
+  benchWarmupRuns = warmupRuns;
+}
+
+//represents bench block
+BenchStatementNode::BenchStatementNode(char* name, AbstractExpressionNode* runs, AbstractStatementNode* body, SymbolTable* symbolTable, uint32_t startLine) {
+  this->name = name;
+  this->runs = runs;
+  this->body = body;
+  this->symbolTable = symbolTable;
+	this->startLine = startLine;
+	this->endLine = body->endLine;
+}
+
+//nanoseconds in the largest unit that keeps them at least 1
+static void printDuration(const char* label, double nanoseconds) {
+
+  if(nanoseconds < 1e3)
+    fprintf(stderr, ", %s %.0f ns", label, nanoseconds);
+  else if(nanoseconds < 1e6)
+    fprintf(stderr, ", %s %.3f us", label, nanoseconds / 1e3);
+  else if(nanoseconds < 1e9)
+    fprintf(stderr, ", %s %.3f ms", label, nanoseconds / 1e6);
+  else
+    fprintf(stderr, ", %s %.3f s", label, nanoseconds / 1e9);
+}
+
+void BenchStatementNode::execute() {
+  COUNT_NODE("BenchStatementNode");
+  profileLine(startLine);
+  runCounters.statements++;
+  burnFuel(startLine);
+  uint64_t traceStart = tracing ? traceClock() : 0;
+
+  //a count below one still runs the block once
+  int64_t count = benchRuns;
+  if(runs != NULL) {
+    ParseData d = runs->evaluate();
+    count = isSignedIntParseDataType(d.type) ? (int32_t) d.value.integer : (uint32_t) d.value.integer;
+  }
+  count = std::max(count, (int64_t) 1);
+
+  ScratchMark mark = scratchMark();
+
+  for(uint32_t i = 0; i < benchWarmupRuns; i++) {
+    body->execute();
+    scratchRelease(mark);
+  }
+
+  std::vector<uint64_t> times(count);
+  for(int64_t i = 0; i < count; i++) {
+    uint64_t start = nanotime();
+    body->execute();
+    scratchRelease(mark);
+    times[i] = nanotime() - start;
+  }
+
+  std::sort(times.begin(), times.end());
+  double median = (count % 2 == 1) ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) / 2.0;
+
+  //the program's own output so far comes first
+  flushOutput();
+  fprintf(stderr, "bench %s: %lld runs", name, (long long) count);
+  printDuration("min", times.front());
+  printDuration("median", median);
+  printDuration("max", times.back());
+  fprintf(stderr, "\n");
+
+  if(tracing)
+    traceSpan(name, "bench", traceStart, startLine);
 }
 
 //represents declaration (and maybe assignment) of a new variable
@@ -156,7 +349,7 @@ NewAssignmentStatementNode::NewAssignmentStatementNode(std::string var, ParseDat
 
 	//if it's an array, add a subtype (this constructor should always be called for array type)
 	if(typ == ARRAY_T) {
-		Array* arr = (Array*) malloc(sizeof(Array));
+		Array* arr = (Array*) allocateProgram(sizeof(Array));
 		arr->subtype = subTyp;
 		d.value.allocated = (void*) arr;
 	}
@@ -193,7 +386,7 @@ NewAssignmentStatementNode::NewAssignmentStatementNode(std::string var, ParseDat
 
 	//if it's an array, add a subtype (this constructor should always be called for array type)
 	if(typ == ARRAY_T) {
-		Array* arr = (Array*) malloc(sizeof(Array));
+		Array* arr = (Array*) allocateProgram(sizeof(Array));
 		arr->subtype = subTyp;
 		d.value.allocated = (void*) arr;
 	}
@@ -202,6 +395,10 @@ NewAssignmentStatementNode::NewAssignmentStatementNode(std::string var, ParseDat
 }
 
 void NewAssignmentStatementNode::execute() {
+	COUNT_NODE("NewAssignmentStatementNode");
+	profileLine(startLine);
+	runCounters.statements++;
+	burnFuel(startLine);
 	executeNewAssignmentStatement(this);
 }
 
@@ -215,6 +412,10 @@ AssignmentStatementNode::AssignmentStatementNode(std::string var, AbstractExpres
 }
 
 void AssignmentStatementNode::execute() {
+	COUNT_NODE("AssignmentStatementNode");
+	profileLine(startLine);
+	runCounters.statements++;
+	burnFuel(startLine);
 	executeAssignmentStatement(this);
 }
 
@@ -228,22 +429,30 @@ ArrayAssignmentStatementNode::ArrayAssignmentStatementNode(std::string var, bool
 	this->startLine = startLine;
 	this->endLine = val->endLine;
 	this->context = context;
+	inRange = NO_SLOT;
 }
 
 void ArrayAssignmentStatementNode::execute() {
+	COUNT_NODE("ArrayAssignmentStatementNode");
+	profileLine(startLine);
+	runCounters.statements++;
+	burnFuel(startLine);
 	executeArrayAssignmentStatement(this);
 }
 
 //represents return statement in a function
-ReturnStatementNode::ReturnStatementNode(AbstractExpressionNode* exp, bool* retFlag, ParseData* retVal, uint32_t startLine) {
+ReturnStatementNode::ReturnStatementNode(AbstractExpressionNode* exp, uint32_t startLine) {
 	expression = exp;
-	returnFlag = retFlag;
-	returnValue = retVal;
+	isTailCall = false;
 	this->startLine = startLine;
 	this->endLine = exp->endLine;
 }
 
 void ReturnStatementNode::execute() {
+	COUNT_NODE("ReturnStatementNode");
+	profileLine(startLine);
+	runCounters.statements++;
+	burnFuel(startLine);
 	executeReturnStatement(this);
 }
 
@@ -270,6 +479,10 @@ FunctionStatementNode::FunctionStatementNode(std::string fName, SymbolTable* sym
 }
 
 void FunctionStatementNode::execute() {
+	COUNT_NODE("FunctionStatementNode");
+	profileLine(startLine);
+	runCounters.statements++;
+	burnFuel(startLine);
 	executeFunctionStatement(this);
 }
 
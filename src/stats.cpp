@@ -0,0 +1,221 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <typeinfo>
+#include <cxxabi.h>
+#include "parsenode.h"
+#include "statementnode.h"
+#include "optimizer.h"
+#include "stats.h"
+#include "trace.h"
+
+thread_local RunCounters runCounters = {};
+
+static const char* PHASE_NAMES[NUM_PHASES] = {"read", "lines", "lex", "parse", "optimize", "execute"};
+
+static ReportFormat timeReport = NO_REPORT;
+static ReportFormat statsReport = NO_REPORT;
+static std::vector<AbstractStatementNode*>* program = NULL;
+
+void setTimeReport(ReportFormat format) {
+	timeReport = format;
+}
+
+void setStatsReport(ReportFormat format) {
+	statsReport = format;
+}
+
+void setReportedProgram(std::vector<AbstractStatementNode*>* statements) {
+	program = statements;
+}
+
+///////////////////////////////////
+///////       Timing        ///////
+///////////////////////////////////
+
+static double wallSeconds[NUM_PHASES];
+static double cpuSeconds[NUM_PHASES];
+static bool phaseRan[NUM_PHASES];
+
+static int32_t currentPhase = -1;
+static double phaseWallStart;
+static double phaseCpuStart;
+static uint64_t phaseTraceStart;
+
+static double wallNow() {
+	std::chrono::duration<double> sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+	return sinceEpoch.count();
+}
+
+static double cpuNow() {
+	struct timespec now;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void endPhase() {
+
+	if(currentPhase < 0)
+		return;
+
+	wallSeconds[currentPhase] += wallNow() - phaseWallStart;
+	cpuSeconds[currentPhase] += cpuNow() - phaseCpuStart;
+	phaseRan[currentPhase] = true;
+
+	if(tracing)
+		traceSpan(PHASE_NAMES[currentPhase], "phase", phaseTraceStart, 0);
+	currentPhase = -1;
+}
+
+void beginPhase(Phase phase) {
+
+	endPhase();
+
+	currentPhase = phase;
+	phaseWallStart = wallNow();
+	phaseCpuStart = cpuNow();
+	phaseTraceStart = tracing ? traceClock() : 0;
+}
+
+static void printTimeText() {
+
+	double totalWall = 0;
+	double totalCpu = 0;
+
+	fprintf(stderr, "%-10s %12s %12s\n", "phase", "wall ms", "cpu ms");
+	for(uint32_t i = 0; i < NUM_PHASES; i++) {
+		if(!phaseRan[i])
+			continue;
+
+		fprintf(stderr, "%-10s %12.3f %12.3f\n", PHASE_NAMES[i], wallSeconds[i] * 1000, cpuSeconds[i] * 1000);
+		totalWall += wallSeconds[i];
+		totalCpu += cpuSeconds[i];
+	}
+	fprintf(stderr, "%-10s %12.3f %12.3f\n", "total", totalWall * 1000, totalCpu * 1000);
+}
+
+static void printTimeJson() {
+
+	fprintf(stderr, "{\"time\": {");
+
+	bool first = true;
+	for(uint32_t i = 0; i < NUM_PHASES; i++) {
+		if(!phaseRan[i])
+			continue;
+
+		fprintf(stderr, "%s\"%s\": {\"wallMs\": %.3f, \"cpuMs\": %.3f}", first ? "" : ", ", PHASE_NAMES[i],
+			wallSeconds[i] * 1000, cpuSeconds[i] * 1000);
+		first = false;
+	}
+
+	fprintf(stderr, "}}\n");
+}
+
+///////////////////////////////////
+///////    Node Counting    ///////
+///////////////////////////////////
+
+static std::string className(const std::type_info& type) {
+
+	int status;
+	char* demangled = abi::__cxa_demangle(type.name(), NULL, NULL, &status);
+	if(status != 0)
+		return type.name();
+
+	std::string name(demangled);
+	free(demangled);
+	return name;
+}
+
+static void countNodes(AbstractExpressionNode* node, std::map<std::string, uint64_t>& counts) {
+
+	counts[className(typeid(*node))]++;
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+	for(uint32_t i = 0; i < children.size(); i++)
+		countNodes(*children[i], counts);
+}
+
+static void countNodes(AbstractStatementNode* node, std::map<std::string, uint64_t>& counts) {
+
+	counts[className(typeid(*node))]++;
+
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++)
+		countNodes(*expressions[i], counts);
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		countNodes(statements[i], counts);
+}
+
+///////////////////////////////////
+///////     Statistics      ///////
+///////////////////////////////////
+
+static void printStatsText(std::map<std::string, uint64_t>& nodes, uint64_t totalNodes) {
+
+	fprintf(stderr, "%-34s %12llu\n", "tokens", (unsigned long long) runCounters.tokens);
+	fprintf(stderr, "%-34s %12llu\n", "nodes", (unsigned long long) totalNodes);
+
+	for(std::map<std::string, uint64_t>::iterator it = nodes.begin(); it != nodes.end(); it++)
+		fprintf(stderr, "  %-32s %12llu\n", it->first.c_str(), (unsigned long long) it->second);
+
+	fprintf(stderr, "%-34s %12llu\n", "statements executed", (unsigned long long) runCounters.statements);
+	fprintf(stderr, "%-34s %12llu\n", "scope pushes", (unsigned long long) runCounters.scopePushes);
+	fprintf(stderr, "%-34s %12llu\n", "scope pops", (unsigned long long) runCounters.scopePops);
+	fprintf(stderr, "%-34s %12llu\n", "function calls", (unsigned long long) runCounters.functionCalls);
+	fprintf(stderr, "%-34s %12llu\n", "allocations", (unsigned long long) runCounters.allocations);
+	fprintf(stderr, "%-34s %12llu\n", "  from scratch region", (unsigned long long) runCounters.scratchAllocations);
+	fprintf(stderr, "%-34s %12llu\n", "bytes allocated", (unsigned long long) runCounters.allocatedBytes);
+}
+
+static void printStatsJson(std::map<std::string, uint64_t>& nodes, uint64_t totalNodes) {
+
+	fprintf(stderr, "{\"stats\": {\"tokens\": %llu, \"nodes\": %llu, \"nodesByClass\": {",
+		(unsigned long long) runCounters.tokens, (unsigned long long) totalNodes);
+
+	for(std::map<std::string, uint64_t>::iterator it = nodes.begin(); it != nodes.end(); it++)
+		fprintf(stderr, "%s\"%s\": %llu", (it == nodes.begin()) ? "" : ", ", it->first.c_str(), (unsigned long long) it->second);
+
+	fprintf(stderr, "}, \"statements\": %llu, \"scopePushes\": %llu, \"scopePops\": %llu, \"functionCalls\": %llu, "
+		"\"allocations\": %llu, \"scratchAllocations\": %llu, \"bytesAllocated\": %llu}}\n",
+		(unsigned long long) runCounters.statements, (unsigned long long) runCounters.scopePushes,
+		(unsigned long long) runCounters.scopePops, (unsigned long long) runCounters.functionCalls, (unsigned long long) runCounters.allocations,
+		(unsigned long long) runCounters.scratchAllocations, (unsigned long long) runCounters.allocatedBytes);
+}
+
+void printReports() {
+
+	endPhase();
+
+	if(timeReport == TEXT_REPORT)
+		printTimeText();
+	else if(timeReport == JSON_REPORT)
+		printTimeJson();
+
+	if(statsReport == NO_REPORT)
+		return;
+
+	//nodes of the tree as it runs, after optimization (none if parsing failed)
+	std::map<std::string, uint64_t> nodes;
+	uint64_t totalNodes = 0;
+
+	if(program != NULL) {
+		for(uint32_t i = 0; i < program->size(); i++)
+			countNodes((*program)[i], nodes);
+	}
+
+	for(std::map<std::string, uint64_t>::iterator it = nodes.begin(); it != nodes.end(); it++)
+		totalNodes += it->second;
+
+	if(statsReport == TEXT_REPORT)
+		printStatsText(nodes, totalNodes);
+	else
+		printStatsJson(nodes, totalNodes);
+}
@@ -0,0 +1,191 @@
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "statementnode.h"
+#include "function.h"
+#include "optimizer.h"
+#include "strength.h"
+#include "context.h"
+
+//largest constant exponent turned into a multiplication loop
+#define MAX_REDUCED_EXPONENT 64
+
+static bool isIncrementOperator(ParseOperatorType op) {
+	return op == POSTFIX_INC_OP || op == POSTFIX_DEC_OP || op == PREFIX_INC_OP || op == PREFIX_DEC_OP;
+}
+
+///////////////////////////////////
+///////  Constant Operands  ///////
+///////////////////////////////////
+
+static void reduceExpression(AbstractExpressionNode** location) {
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(*location);
+	for(uint32_t i = 0; i < children.size(); i++)
+		reduceExpression(children[i]);
+
+	ArithmeticOperatorNode* node = dynamic_cast<ArithmeticOperatorNode*>(*location);
+	if(node == NULL)
+		return;
+
+	int64_t constant = intLiteralValue(node->rightArg);
+
+	if(node->operation == EXPONENT_OP && constant >= 0 && constant <= MAX_REDUCED_EXPONENT) {
+		*location = new IntegerPowerNode(node);
+
+	} else if((node->operation == DIVIDE_OP || node->operation == MOD_OP) && constant > 0) {
+		*location = new ConstantDivisionNode(node);
+	}
+}
+
+///////////////////////////////////
+/////// Induction Variables ///////
+///////////////////////////////////
+
+//true if the expression calls a function or writes to the variable
+static bool expressionInterferes(AbstractExpressionNode* node, std::string variable) {
+
+	if(dynamic_cast<FunctionExpressionNode*>(node) != NULL)
+		return true;
+
+	if(AssignmentExpressionNode* n = dynamic_cast<AssignmentExpressionNode*>(node)) {
+		if(n->variable == variable)
+			return true;
+	}
+
+	if(UnaryOperatorNode* n = dynamic_cast<UnaryOperatorNode*>(node)) {
+		VariableNode* var = dynamic_cast<VariableNode*>(n->leftArg);
+		if(isIncrementOperator(n->operation) && var != NULL && var->variable == variable)
+			return true;
+	}
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(node);
+	for(uint32_t i = 0; i < children.size(); i++) {
+		if(expressionInterferes(*children[i], variable))
+			return true;
+	}
+
+	return false;
+}
+
+//true if the statement calls a function, writes to the variable or declares another one with its name
+//(functions declared in the loop are rejected too, their parameters could shadow the variable)
+static bool statementInterferes(AbstractStatementNode* node, std::string variable) {
+
+	if(NewAssignmentStatementNode* n = dynamic_cast<NewAssignmentStatementNode*>(node)) {
+		if(n->variable == variable)
+			return true;
+	}
+
+	if(AssignmentStatementNode* n = dynamic_cast<AssignmentStatementNode*>(node)) {
+		if(n->variable == variable)
+			return true;
+	}
+
+	if(dynamic_cast<FunctionStatementNode*>(node) != NULL)
+		return true;
+
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++) {
+		if(expressionInterferes(*expressions[i], variable))
+			return true;
+	}
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++) {
+		if(statementInterferes(statements[i], variable))
+			return true;
+	}
+
+	return false;
+}
+
+//replace loop variable times an int constant with a value the loop keeps up to date
+static void replaceProducts(AbstractExpressionNode** location, ForStatementNode* loop, std::string variable, int64_t step) {
+
+	std::vector<AbstractExpressionNode**> children = childExpressions(*location);
+	for(uint32_t i = 0; i < children.size(); i++)
+		replaceProducts(children[i], loop, variable, step);
+
+	ArithmeticOperatorNode* node = dynamic_cast<ArithmeticOperatorNode*>(*location);
+	if(node == NULL || node->operation != MULTIPLY_OP)
+		return;
+
+	VariableNode* leftVar = dynamic_cast<VariableNode*>(node->leftArg);
+	VariableNode* rightVar = dynamic_cast<VariableNode*>(node->rightArg);
+	int64_t constant;
+
+	if(leftVar != NULL && leftVar->variable == variable) {
+		constant = intLiteralValue(node->rightArg);
+	} else if(rightVar != NULL && rightVar->variable == variable) {
+		constant = intLiteralValue(node->leftArg);
+	} else {
+		return;
+	}
+
+	if(constant < 0)
+		return;
+
+	InductionVariable induction;
+	induction.product = node;
+	induction.value = reserveSlots(1);
+	induction.increment = (uint64_t) (step * constant);
+	loop->inductionVariables.push_back(induction);
+
+	*location = new InductionVariableNode(node, induction.value);
+}
+
+static void replaceProducts(AbstractStatementNode* node, ForStatementNode* loop, std::string variable, int64_t step) {
+
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++)
+		replaceProducts(expressions[i], loop, variable, step);
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		replaceProducts(statements[i], loop, variable, step);
+}
+
+//only integer loop variables declared by the loop itself and changed only by its update
+static void reduceInductionVariables(ForStatementNode* loop) {
+
+	NewAssignmentStatementNode* init = dynamic_cast<NewAssignmentStatementNode*>(loop->initialization);
+	if(init == NULL)
+		return;
+
+	ParseDataType type = init->type;
+	if(type != INT32_T && type != INT64_T && type != UINT32_T && type != UINT64_T)
+		return;
+
+	std::string variable = init->variable;
+	int64_t step = loopStep(loop->update, variable);
+
+	if(step == 0 || expressionInterferes(loop->condition, variable) || statementInterferes(loop->body, variable))
+		return;
+
+	replaceProducts(&loop->condition, loop, variable, step);
+	replaceProducts(loop->body, loop, variable, step);
+}
+
+static void reduceStatement(AbstractStatementNode* node) {
+
+	if(ForStatementNode* loop = dynamic_cast<ForStatementNode*>(node))
+		reduceInductionVariables(loop);
+
+	std::vector<AbstractExpressionNode**> expressions = childExpressions(node);
+	for(uint32_t i = 0; i < expressions.size(); i++)
+		reduceExpression(expressions[i]);
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		reduceStatement(statements[i]);
+}
+
+void reduceStrength(std::vector<AbstractStatementNode*>* statements) {
+
+	for(uint32_t i = 0; i < statements->size(); i++)
+		reduceStatement((*statements)[i]);
+}
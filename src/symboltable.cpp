@@ -4,6 +4,8 @@
 #include <unordered_map>
 #include "parsetoken.h"
 #include "symboltable.h"
+#include "stats.h"
+#include "counters.h"
 
 using namespace std;
 
@@ -13,16 +15,30 @@ SymbolTable::SymbolTable() {
 	depth = 0;
 }
 
+SymbolTable::~SymbolTable() {
+  for(uint32_t i = 0; i < table->size(); i++)
+    delete (*table)[i];
+  delete table;
+}
+
 void SymbolTable::enterNewScope() {
   //the next time something is added, a new symbol table is created
   table->push_back(new unordered_map<string, ParseData>());
 	depth++;
+	runCounters.scopePushes++;
 }
 
 void SymbolTable::leaveScope() {
   //leave a scope, so discard "innermost" symbol table
+  delete table->back();
   table->pop_back();
 	depth--;
+	runCounters.scopePops++;
+}
+
+void SymbolTable::clearScope() {
+  //discard everything declared in the innermost scope, but stay in it
+  table->back()->clear();
 }
 
 //create new key in innermost scope
@@ -90,11 +106,14 @@ ParseData SymbolTable::get(string var) {
     
     //see if this map contains the variable
     unordered_map<string, ParseData>::const_iterator value = map->find(var);
-    if(value != map->end())
+    if(value != map->end()) {
+      COUNT_LOOKUP(rit - table->rbegin(), true);
       return value->second;
+    }
   }
   
   //not found, return "invalid" data
+  COUNT_LOOKUP(table->size(), false);
   ParseData d;
   d.type = INVALID_T;
   return d;
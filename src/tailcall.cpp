@@ -0,0 +1,59 @@
+#include <vector>
+#include <cstdint>
+#include "parsetoken.h"
+#include "parsenode.h"
+#include "statementnode.h"
+#include "function.h"
+#include "optimizer.h"
+#include "tailcall.h"
+
+//a statement is in tail position if nothing in the function runs after it
+static void markTailPosition(AbstractStatementNode* node, Function* function) {
+
+	if(ReturnStatementNode* n = dynamic_cast<ReturnStatementNode*>(node)) {
+
+		AbstractExpressionNode* expression = n->expression;
+		while(GroupedExpressionNode* group = dynamic_cast<GroupedExpressionNode*>(expression))
+			expression = group->closedExpression;
+
+		FunctionExpressionNode* call = dynamic_cast<FunctionExpressionNode*>(expression);
+		if(call != NULL && call->function == function) {
+			n->expression = call;
+			n->isTailCall = true;
+		}
+
+	} else if(ConditionalStatementNode* n = dynamic_cast<ConditionalStatementNode*>(node)) {
+
+		//the chosen branch is the last thing the conditional runs
+		for(uint32_t i = 0; i < n->statements->size(); i++)
+			markTailPosition((*n->statements)[i], function);
+
+	} else if(GroupedStatementNode* n = dynamic_cast<GroupedStatementNode*>(node)) {
+
+		//a return doesn't stop the rest of a block, so only its last statement counts
+		if(!n->statements->empty())
+			markTailPosition(n->statements->back(), function);
+	}
+}
+
+static void markStatement(AbstractStatementNode* node) {
+
+	//the function's top-level loop stops at any return, so every top-level statement is a candidate
+	if(FunctionStatementNode* n = dynamic_cast<FunctionStatementNode*>(node)) {
+		if(n->function != NULL) {
+			std::vector<AbstractStatementNode*>* body = n->function->body;
+			for(uint32_t i = 0; i < body->size(); i++)
+				markTailPosition((*body)[i], n->function);
+		}
+	}
+
+	std::vector<AbstractStatementNode*> statements = childStatements(node);
+	for(uint32_t i = 0; i < statements.size(); i++)
+		markStatement(statements[i]);
+}
+
+void markTailCalls(std::vector<AbstractStatementNode*>* statements) {
+
+	for(uint32_t i = 0; i < statements->size(); i++)
+		markStatement((*statements)[i]);
+}
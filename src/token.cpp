@@ -8,18 +8,18 @@
 #include "token.h"
 
 static const char* RESERVED_WORDS[] = {"for", "while", "do", "if", "elif", "else", "break",
-                               "switch", "case", "class", "extends", "fun", "return", "new", "print", "println", "int8",
+                               "switch", "case", "class", "extends", "fun", "return", "new", "print", "println", "printf", "bench", "int8",
                               "int16", "int32", "int64", "uint8", "uint16",
                               "uint32", "uint64", "int", "long", "char", "double", "bool",
                               "string", "void", "true", "false"};
 
 static const TokenType RESERVED_WORD_TOKENS[] = { FOR, WHILE, DO, IF, ELIF, ELSE, BREAK,
-                                    SWITCH, CASE, CLASS, EXTENDS, FUN, RETURN, NEW, PRINT, PRINTLN,
+                                    SWITCH, CASE, CLASS, EXTENDS, FUN, RETURN, NEW, PRINT, PRINTLN, PRINTF, BENCH,
 																		INT8, INT16, INT32, INT64, UINT8, UINT16,
                                     UINT32, UINT64, INT32, INT64, CHAR, DOUBLE, BOOL,
                                     STRING, VOID, TRUE, FALSE};
 
-static const uint8_t NUM_RESERVED_WORDS = 31;
+static const uint8_t NUM_RESERVED_WORDS = 33;
 
 //Token class constructors
 //full "constructor"
@@ -119,6 +119,8 @@ const char* toStringTokenType(TokenType tokenType) {
 		case NEW: return "NEW";
     case PRINT: return "PRINT";
     case PRINTLN: return "PRINTLN";
+    case PRINTF: return "PRINTF";
+    case BENCH: return "BENCH";
     case TRUE: return "TRUE";
     case FALSE: return "FALSE";
     case END: return "END";
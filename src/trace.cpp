@@ -0,0 +1,106 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include "trace.h"
+
+bool tracing = false;
+
+struct TraceEvent {
+	const char* name;
+	const char* category;
+	uint64_t start;
+	uint64_t end;
+	uint32_t line;
+};
+
+static const char* traceFile;
+static uint32_t maxEvents;
+static uint64_t traceStart;
+static uint64_t droppedEvents = 0;
+static std::vector<TraceEvent> events;
+
+uint64_t traceClock() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void traceSpan(const char* name, const char* category, uint64_t start, uint32_t line) {
+
+	if(events.size() >= maxEvents) {
+		droppedEvents++;
+		return;
+	}
+
+	TraceEvent event;
+	event.name = name;
+	event.category = category;
+	event.start = start;
+	event.end = traceClock();
+	event.line = line;
+	events.push_back(event);
+}
+
+//names come from the program (bench blocks), so they can hold quotes, backslashes and control characters
+static void writeJsonString(FILE* out, const char* str) {
+
+	fputc('"', out);
+	for(const char* c = str; *c; c++) {
+		if(*c == '"' || *c == '\\')
+			fprintf(out, "\\%c", *c);
+		else if((unsigned char) *c < 0x20)
+			fprintf(out, "\\u%04x", (unsigned char) *c);
+		else
+			fputc(*c, out);
+	}
+	fputc('"', out);
+}
+
+//trace event times are in microseconds
+static void writeTrace() {
+
+	tracing = false;
+
+	FILE* out = fopen(traceFile, "w");
+	if(out == NULL) {
+		fprintf(stderr, "Couldn't write the trace to %s: %s\n", traceFile, strerror(errno));
+		return;
+	}
+
+	fprintf(out, "{\"traceEvents\": [\n");
+	fprintf(out, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"ash\"}}");
+
+	for(uint32_t i = 0; i < events.size(); i++) {
+		TraceEvent& event = events[i];
+		fprintf(out, ",\n{\"name\": ");
+		writeJsonString(out, event.name);
+		fprintf(out, ", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1",
+			event.category, (event.start - traceStart) / 1e3, (event.end - event.start) / 1e3);
+
+		//phases aren't tied to a line
+		if(event.line != 0)
+			fprintf(out, ", \"args\": {\"line\": %u}", event.line);
+		fprintf(out, "}");
+	}
+
+	fprintf(out, "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"droppedEvents\": %llu}}\n", (unsigned long long) droppedEvents);
+	fclose(out);
+
+	if(droppedEvents > 0)
+		fprintf(stderr, "The trace was limited to %u events, %llu more were dropped\n", maxEvents, (unsigned long long) droppedEvents);
+}
+
+void startTracing(const char* file, uint32_t limit) {
+
+	traceFile = file;
+	maxEvents = limit;
+	traceStart = traceClock();
+
+	//a small first buffer, the rest is only taken by programs that need it
+	events.reserve(limit < 4096 ? limit : 4096);
+
+	tracing = true;
+	atexit(writeTrace);
+}
@@ -175,3 +175,12 @@ ParseDataType getTypeComparisonExpression(ParseOperatorType op, ParseDataType l,
   return BOOL_T;
 }
 
+//both clocks count nanoseconds
+ParseDataType getTypeBuiltinFunctionExpression(BuiltinFunction f) {
+
+  switch(f) {
+    case NANOTIME_FUN: return UINT64_T;
+    case CPUTIME_FUN: return UINT64_T;
+    default: return INVALID_T;
+  }
+}
@@ -5,15 +5,18 @@
 #include "utils.h"
 #include "errors.h"
 #include "symboltable.h"
+#include "context.h"
 #include "token.h"
 #include "typehandler.h"
 #include "parsetoken.h"
 #include "parsenode.h"
+#include "counters.h"
 
 
 ParseData evaluateUnaryExpression(UnaryOperatorNode* node) {
   
   ParseData arg = node->leftArg->evaluate();
+  COUNT_OPERATION(node->operation, arg.type, INVALID_T);
   ParseData d;
   d.type = arg.type;
   
@@ -207,7 +210,7 @@ ParseData evaluateUnaryExpression(UnaryOperatorNode* node) {
         update.value.integer = d.value.integer + 1;
       }
 
-      SymbolTable* symbolTable = node->symbolTable;
+      SymbolTable* symbolTable = &runningContext->variables;
       symbolTable->update(variableName, update);
 
       //return original value
@@ -273,7 +276,7 @@ ParseData evaluateUnaryExpression(UnaryOperatorNode* node) {
         update.value.integer = d.value.integer - 1;
       }
 
-      SymbolTable* symbolTable = node->symbolTable;
+      SymbolTable* symbolTable = &runningContext->variables;
       symbolTable->update(variableName, update);
 
       //return original value
@@ -331,7 +334,7 @@ ParseData evaluateUnaryExpression(UnaryOperatorNode* node) {
       }
 
       //update value in symbol table
-      SymbolTable* symbolTable = node->symbolTable;
+      SymbolTable* symbolTable = &runningContext->variables;
       symbolTable->update(variableName, d);
 
       //return original value
@@ -387,7 +390,7 @@ ParseData evaluateUnaryExpression(UnaryOperatorNode* node) {
         }
       }
 
-      SymbolTable* symbolTable = node->symbolTable;
+      SymbolTable* symbolTable = &runningContext->variables;
       symbolTable->update(variableName, d);
 
       //return original value
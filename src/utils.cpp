@@ -5,12 +5,13 @@
 #include <algorithm>
 #include "array.h"
 #include "utils.h"
+#include "scratch.h"
 
 //allocate a char* copy of a string
 char* copyString(const char* str) {
 
 	uint32_t len = strlen(str);
-	char* copy = new char[len+1];
+	char* copy = (char*) allocateHeap(len+1);
 	copy[0] = '\0';
 
 	strcpy(copy, str);
@@ -19,10 +20,17 @@ char* copyString(const char* str) {
 	return copy;
 }
 
+//terminate a number formatted into text and allocate a copy of it
+char* copyNumber(char* text, uint32_t length) {
+
+	text[length] = '\0';
+	return copyString(text);
+}
+
 //allocate a char* subtring
 char* copySubstring(const char* str, int32_t startIndex, int32_t pastEndIndex) {
 
-	char* copy = new char[std::max(pastEndIndex-startIndex+1, 1)];
+	char* copy = (char*) allocateValue(std::max(pastEndIndex-startIndex+1, 1));
 	for(int32_t i = startIndex; i < pastEndIndex; i++) {
 		copy[i-startIndex] = str[i];
 	}
@@ -37,13 +45,13 @@ Array* copySubarray(Array* arr, int32_t startIndex, int32_t pastEndIndex) {
 	//extract fields from Array
 	ParseData* values = arr->values;
 
-	ParseData* subarrayValues = (ParseData*) malloc(sizeof(ParseData) * std::max(pastEndIndex-startIndex, 1));
+	ParseData* subarrayValues = (ParseData*) allocateValue(sizeof(ParseData) * std::max(pastEndIndex-startIndex, 1));
 	for(int32_t i = startIndex; i < pastEndIndex; i++) {
 		subarrayValues[i-startIndex] = values[i];
 	}
 
 	//create subarray Array and return it
-	Array* subarray = (Array*) malloc(sizeof(Array));
+	Array* subarray = (Array*) allocateValue(sizeof(Array));
 	subarray->length = (uint32_t) std::max(pastEndIndex-startIndex, 0);
 	subarray->subtype = arr->subtype;
 	subarray->values = subarrayValues;
@@ -0,0 +1,273 @@
+//tests of the embedding interface in include/ash.h, built and run against bin/libash.a by make lib-test
+//prints every check that fails and exits with 1 if there was one
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include "ash.h"
+#include "scratch.h"
+#include "exceptions.h"
+#include "profile.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+	if(!ok) {
+		printf("FAILED: %s\n", name);
+		failures++;
+	}
+}
+
+static void checkOutput(const std::string& output, const char* expected, const char* name) {
+	if(output != expected) {
+		printf("FAILED: %s\n\texpected: %s\n\tgot: %s\n", name, expected, output.c_str());
+		failures++;
+	}
+}
+
+//the message of the Error run throws, or "" if it doesn't throw
+template<typename F>
+static std::string errorOf(F run) {
+	try {
+		run();
+	} catch(ash::Error& e) {
+		return e.what();
+	}
+	return "";
+}
+
+static bool contains(const std::string& str, const char* part) {
+	return str.find(part) != std::string::npos;
+}
+
+///////////////////////////////////
+///////      Natives        ///////
+///////////////////////////////////
+
+static ParseData twice(ParseData* args) {
+	ParseData d;
+	d.value.integer = args[0].value.integer * 2;
+	return d;
+}
+
+static ParseData greet(ParseData* args) {
+	const char* name = (const char*) args[0].value.allocated;
+	char* result = (char*) allocateValue(strlen(name) + 7);
+	strcpy(result, "hello ");
+	strcat(result, name);
+	ParseData d;
+	d.value.allocated = (void*) result;
+	return d;
+}
+
+static ParseData refuse(ParseData* args) {
+	throw NativeException("refused");
+}
+
+//runs another program from inside a function of the one calling it
+static ash::Program* inner = NULL;
+
+static ParseData runInner(ParseData* args) {
+	ParseData d;
+	d.value.integer = atoi(inner->run().c_str());
+	return d;
+}
+
+///////////////////////////////////
+///////       Tests         ///////
+///////////////////////////////////
+
+static void compileAndRun() {
+
+	ash::Engine engine;
+	ash::Program* program = engine.compile(
+		"fun square(int x) -> int {\n"
+		"  return x * x\n"
+		"}\n"
+		"println square(7)\n"
+		"printf \"%s-%d\\n\", \"a\", 3\n");
+
+	checkOutput(program->run(), "49\na-3\n", "run returns the output");
+	checkOutput(program->run(), "49\na-3\n", "a program runs again the same way");
+
+	std::string output = "before\n";
+	program->run(output);
+	checkOutput(output, "before\n49\na-3\n", "run appends to the output");
+
+	std::string message = errorOf([&]() { delete engine.compile("int x = \"a\"\n"); });
+	check(!message.empty(), "a program that doesn't compile throws Error");
+
+	delete program;
+}
+
+static void globals() {
+
+	ash::Engine engine;
+	engine.declareGlobal("n", INT32_T);
+	engine.declareGlobal("x", DOUBLE_T);
+	engine.declareGlobal("flag", BOOL_T);
+	engine.declareGlobal("name", STRING_T);
+	ash::Program* program = engine.compile(
+		"println n + 1\n"
+		"println x / 2\n"
+		"if(flag) {\n"
+		"  println \"on\"\n"
+		"}\n"
+		"println \"[\" + name + \"]\"\n");
+
+	checkOutput(program->run(), "1\n0.0\n[]\n", "globals without a value are 0, false or empty");
+
+	ash::Globals values;
+	values.set("n", 2.9);
+	values.set("x", 5);
+	values.set("flag", true);
+	values.set("name", "ash");
+	checkOutput(program->run(values), "3\n2.5\non\n[ash]\n", "globals are converted to their declared types");
+
+	values.set("name", std::string("again"));
+	checkOutput(program->run(values), "3\n2.5\non\n[again]\n", "a global is set again");
+
+	ash::Globals unknown;
+	unknown.set("m", 1);
+	std::string message = errorOf([&]() { program->run(unknown); });
+	check(contains(message, "No global named m"), "an undeclared global is an error");
+
+	message = errorOf([&]() { engine.declareGlobal("list", ARRAY_T); });
+	check(contains(message, "A global can't have type"), "a global can't be an array");
+
+	message = errorOf([&]() { delete engine.compile("int n = 3\n"); });
+	check(!message.empty(), "a program can't declare a global again");
+
+	delete program;
+}
+
+static void natives() {
+
+	ash::Engine engine;
+	engine.registerNative("twice", INT32_T, std::vector<ParseDataType>(1, INT32_T), twice);
+	engine.registerNative("greet", STRING_T, std::vector<ParseDataType>(1, STRING_T), greet);
+	engine.registerNative("refuse", VOID_T, std::vector<ParseDataType>(), refuse);
+
+	ash::Program* program = engine.compile("println twice(21)\nprintln greet(\"ash\")\nprintln sqrt(16.0)\n");
+	checkOutput(program->run(), "42\nhello ash\n4.0\n", "natives are called with converted arguments");
+	delete program;
+
+	std::string message = errorOf([&]() { engine.registerNative("list", ARRAY_T, std::vector<ParseDataType>(), twice); });
+	check(contains(message, "A native function can't return"), "a native can't return an array");
+
+	message = errorOf([&]() { engine.registerNative("list", INT32_T, std::vector<ParseDataType>(1, ARRAY_T), twice); });
+	check(contains(message, "A native function can't take"), "a native can't take an array");
+
+	//output capture on error, what was printed before the error stays in the output
+	program = engine.compile("println 1\nrefuse()\nprintln 2\n");
+	std::string output;
+	message = errorOf([&]() { program->run(output); });
+	checkOutput(output, "1\n", "the output until a runtime error is kept");
+	check(contains(message, "NativeException on line 2") && contains(message, "refused"), "a native throws a runtime error");
+	delete program;
+
+	program = engine.compile("println 1\nint[] a = new int[2]\nprintln a[5]\n");
+	output.clear();
+	message = errorOf([&]() { program->run(output); });
+	checkOutput(output, "1\n", "the output until an out of bounds access is kept");
+	check(contains(message, "OutOfBoundsException"), "an out of bounds access is an error");
+	delete program;
+}
+
+static void teardown() {
+
+	ash::Engine* engine = new ash::Engine();
+	engine->declareGlobal("n", INT32_T);
+	engine->registerNative("twice", INT32_T, std::vector<ParseDataType>(1, INT32_T), twice);
+	ash::Program* program = engine->compile("println twice(n)\n");
+	delete engine;
+
+	ash::Globals values;
+	values.set("n", 4);
+	checkOutput(program->run(values), "8\n", "a program runs after its engine is deleted");
+	delete program;
+}
+
+static void concurrentRuns() {
+
+	ash::Engine engine;
+	engine.declareGlobal("n", INT32_T);
+	ash::Program* program = engine.compile(
+		"fun fib(int x) -> int {\n"
+		"  if(x < 2)\n"
+		"    return x\n"
+		"  return fib(x-1) + fib(x-2)\n"
+		"}\n"
+		"string s = \"\"\n"
+		"for(int i = 0; i < n; i++) {\n"
+		"  s += \"x\"\n"
+		"}\n"
+		"println fib(n)\n"
+		"println s\n");
+
+	std::vector<std::string> expected;
+	for(int t = 0; t < 8; t++) {
+		ash::Globals values;
+		values.set("n", 10 + t);
+		expected.push_back(program->run(values));
+	}
+
+	std::vector<std::string> outputs(8);
+	std::vector<std::thread> threads;
+	for(int t = 0; t < 8; t++) {
+		threads.push_back(std::thread([&, t]() {
+			ash::Globals values;
+			values.set("n", 10 + t);
+			for(int run = 0; run < 20; run++) {
+				std::string output;
+				program->run(output, values);
+				if(output != expected[t])
+					outputs[t] = output;
+			}
+		}));
+	}
+	for(uint32_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	for(int t = 0; t < 8; t++)
+		check(outputs[t].empty(), "runs on several threads give the same output as one at a time");
+
+	delete program;
+}
+
+static void nestedRun() {
+
+	ash::Engine engine;
+	inner = engine.compile("fun f(int x) -> int {\n  return x * 3\n}\nprintln f(10)\n");
+	engine.registerNative("inner", INT32_T, std::vector<ParseDataType>(), runInner);
+	ash::Program* outer = engine.compile("fun g() -> int {\n  int a = inner()\n  return a * 3\n}\nprintln g()\nprintln g()\n");
+
+	checkOutput(outer->run(), "90\n90\n", "a native runs another program");
+	check(profileTop == profileStack && profileDepth == 0, "a nested run leaves the profiler's shadow stack as it was");
+	checkOutput(outer->run(), "90\n90\n", "a program runs again after a nested run");
+
+	delete outer;
+	delete inner;
+	inner = NULL;
+}
+
+int main() {
+
+	compileAndRun();
+	globals();
+	natives();
+	teardown();
+	concurrentRuns();
+	nestedRun();
+
+	if(failures > 0) {
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+	return 0;
+}